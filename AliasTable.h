@@ -0,0 +1,158 @@
+#ifndef ALIASTABLE_H
+#define ALIASTABLE_H
+
+#include <array>
+#include "RandomEngine.h"
+#include "Distributions.h"
+using namespace std;
+
+/* AliasTable
+ * Walker's alias method, built with Vose's algorithm, for a table of N rows
+ * with integer weights.  Every column holds TOTAL weight: row i takes the
+ * first threshold[i] of it and alias[i] the rest.  A sample is one canonical
+ * draw u, r = floor(u * N * TOTAL), column r / TOTAL, kept if r % TOTAL is
+ * below the column's threshold; so any table costs one draw and one
+ * comparison, and since the weights stay integers the row probabilities are
+ * exactly weight / TOTAL.
+ *
+ * Tables are built at compile time from the dice tables of "Architect of
+ * Worlds" by makeThreeD6Table and makePercentileTable.  A table row is given
+ * by the highest roll that lands on it, as in the book; the first row also
+ * takes every lower roll and the last every higher one.  ROLLSREPLACED and
+ * BRANCHESREPLACED record the dice and the expected if/else comparisons the
+ * table stands in for, so the benchmark can report what it saves.
+ */
+template <int N>
+struct AliasTable
+{
+	int total = 0;
+	int threshold[N] = {};
+	int alias[N] = {};
+	int rollsReplaced = 0;
+	double branchesReplaced = 0;
+
+	int operator() (RandomEngine & e) const;
+};
+
+#ifdef RANDOM_ENGINE_COUNT_DRAWS
+// samples taken on this thread and what they saved; for benchmarks only
+inline thread_local unsigned long long aliasSampleCount = 0;
+inline thread_local unsigned long long aliasRollsSaved = 0;
+inline thread_local double aliasBranchesSaved = 0;
+#endif
+
+template <int N>
+int AliasTable<N>::operator() (RandomEngine & e) const {
+#ifdef RANDOM_ENGINE_COUNT_DRAWS
+	aliasSampleCount++;
+	aliasRollsSaved += rollsReplaced - 1;
+	aliasBranchesSaved += branchesReplaced - 1;
+#endif
+	int r = (int) (uniformCanonical(e) * ((double) N * total));
+	int column = r / total;
+	return (r % total < threshold[column]) ? column : alias[column];
+}
+
+/* makeAliasTable
+ * Vose's algorithm over integer weights, every weight scaled by N so that
+ * the columns split without rounding
+ */
+template <int N>
+constexpr AliasTable<N> makeAliasTable (const array<int, N> & weights) {
+	AliasTable<N> table;
+	for (int i = 0; i < N; i++) { table.total += weights[i]; }
+
+	int scaled[N] = {};
+	int small[N] = {};
+	int large[N] = {};
+	int smallCount = 0;
+	int largeCount = 0;
+	for (int i = 0; i < N; i++) {
+		scaled[i] = weights[i] * N;
+		if (scaled[i] < table.total) { small[smallCount++] = i; }
+		else { large[largeCount++] = i; }
+	}
+
+	while (smallCount > 0 && largeCount > 0) {
+		int s = small[--smallCount];
+		int l = large[--largeCount];
+		table.threshold[s] = scaled[s];
+		table.alias[s] = l;
+		scaled[l] -= table.total - scaled[s];
+		if (scaled[l] < table.total) { small[smallCount++] = l; }
+		else { large[largeCount++] = l; }
+	}
+	// integer weights leave every remaining column exactly full
+	while (largeCount > 0) {
+		int l = large[--largeCount];
+		table.threshold[l] = table.total;
+		table.alias[l] = l;
+	}
+	while (smallCount > 0) {
+		int s = small[--smallCount];
+		table.threshold[s] = table.total;
+		table.alias[s] = s;
+	}
+
+	// an if/else chain down the rows stops at the row it lands on, or one
+	// short of the end since the last row is the final else
+	for (int i = 0; i < N; i++) {
+		int comparisons = (i + 1 < N - 1) ? i + 1 : N - 1;
+		table.branchesReplaced += (double) weights[i] * comparisons / table.total;
+	}
+	return table;
+}
+
+/* makeThreeD6Table
+ * Table of rows by the highest 3d6 + MODIFIER roll on each
+ */
+template <int N>
+constexpr AliasTable<N> makeThreeD6Table (const array<int, N> & highestRolls, int modifier = 0) {
+	// ways to roll 3 to 18 on 3d6
+	const int ways[16] = { 1, 3, 6, 10, 15, 21, 25, 27, 27, 25, 21, 15, 10, 6, 3, 1 };
+	array<int, N> weights = {};
+	for (int roll = 3; roll <= 18; roll++) {
+		int row = 0;
+		while (row < N - 1 && roll + modifier > highestRolls[row]) { row++; }
+		weights[row] += ways[roll - 3];
+	}
+
+	AliasTable<N> table = makeAliasTable<N>(weights);
+	table.rollsReplaced = 3;
+	return table;
+}
+
+/* makePercentileTable
+ * Table of rows by the highest d100 roll on each
+ */
+template <int N>
+constexpr AliasTable<N> makePercentileTable (const array<int, N> & highestRolls) {
+	array<int, N> weights = {};
+	for (int roll = 1; roll <= 100; roll++) {
+		int row = 0;
+		while (row < N - 1 && roll > highestRolls[row]) { row++; }
+		weights[row]++;
+	}
+
+	AliasTable<N> table = makeAliasTable<N>(weights);
+	table.rollsReplaced = 1;
+	return table;
+}
+
+/* THREE_D6
+ * The plain 3d6 roll, row 0 being a roll of 3, for the tables whose rows do
+ * more than pick a value and so still need the roll itself
+ */
+constexpr AliasTable<16> makeThreeD6Roll () {
+	AliasTable<16> table = makeThreeD6Table<16>({ 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18 });
+	table.branchesReplaced = 1; // the caller's chain still follows
+	return table;
+}
+
+constexpr AliasTable<16> THREE_D6 = makeThreeD6Roll();
+
+inline int rollThreeD6 (RandomEngine & e) {
+	return THREE_D6(e) + 3;
+}
+
+#endif // ALIASTABLE_H
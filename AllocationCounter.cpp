@@ -0,0 +1,39 @@
+#include <new>
+#include <cstdlib>          // malloc, aligned_alloc, free
+#include "AllocationCounter.h"
+using namespace std;
+
+// per thread, so that counting costs no more than an increment
+static thread_local unsigned long long heapAllocations = 0;
+
+unsigned long long getHeapAllocationCount () {
+	return heapAllocations;
+}
+
+///////////////////////////////////////
+// HELPERS
+///////////////////////////////////////
+
+/* The global operator new and delete, replaced so that every heap
+ * allocation is counted; the array, nothrow and sized forms all end up in
+ * these.
+ */
+void * operator new (size_t bytes) {
+	heapAllocations++;
+	void * p = malloc(bytes > 0 ? bytes : 1);
+	if (p == nullptr) { throw bad_alloc(); }
+	return p;
+}
+
+void * operator new (size_t bytes, align_val_t alignment) {
+	heapAllocations++;
+	size_t a = (size_t) alignment;
+	void * p = aligned_alloc(a, (bytes + a - 1) / a * a + (bytes == 0 ? a : 0));
+	if (p == nullptr) { throw bad_alloc(); }
+	return p;
+}
+
+void operator delete (void * p) noexcept { free(p); }
+void operator delete (void * p, size_t) noexcept { free(p); }
+void operator delete (void * p, align_val_t) noexcept { free(p); }
+void operator delete (void * p, size_t, align_val_t) noexcept { free(p); }
@@ -0,0 +1,14 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+using namespace std;
+
+/* getHeapAllocationCount
+ * How many times this thread has called operator new so far.  Only counted
+ * in programs that link AllocationCounter.o, which replaces the global
+ * operator new and delete; take the difference of two calls to see what a
+ * piece of code allocates.
+ */
+unsigned long long getHeapAllocationCount ();
+
+#endif // ALLOCATIONCOUNTER_H
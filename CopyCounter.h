@@ -0,0 +1,32 @@
+#ifndef COPYCOUNTER_H
+#define COPYCOUNTER_H
+
+#include <cstddef>
+#include <cstring>          // memcpy
+using namespace std;
+
+/* Copy counting
+ * Only the copy benchmark (bench/CopyBench, built by "make bench") defines
+ * COUNT_COPIES.  It gives Star, Planet, Moon and Atmosphere copy
+ * constructors and assignments that call copyCounted, so every copy or move
+ * of one, wherever it happens, adds the object's size to bytesCopied.
+ * Without COUNT_COPIES nothing here is compiled: the types keep their
+ * implicit copies and stay trivially copyable.
+ */
+#ifdef COUNT_COPIES
+// bytes of stars, planets, moons and atmospheres copied on this thread
+inline thread_local unsigned long long bytesCopied = 0;
+
+/* copyCounted
+ * Copies SOURCE's bytes over TARGET, as the implicit copy would, and counts
+ * them.  A planet's moons and atmosphere come with it, and are counted as
+ * part of it.
+ */
+template <typename T>
+void copyCounted (T & target, const T & source) {
+	memcpy((void *) &target, (const void *) &source, sizeof(T));
+	bytesCopied += sizeof(T);
+}
+#endif
+
+#endif // COPYCOUNTER_H
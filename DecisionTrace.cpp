@@ -0,0 +1,129 @@
+#include <iostream>
+#include <string>
+#include <cstring>          // memcmp
+#include "DecisionTrace.h"
+using namespace std;
+
+thread_local DecisionTrace * activeTrace = nullptr;
+
+static const char TRACE_MAGIC[4] = { 'G', 'S', 'T', 'R' };
+static const uint32_t TRACE_FORMAT_VERSION = 1;
+
+DecisionTrace::DecisionTrace(int s)
+{
+	seed = s;
+	first = 0;
+	count = 0;
+	dropped = 0;
+}
+
+///////////////////////////////////////
+// ACCESSORS
+///////////////////////////////////////
+
+int DecisionTrace::GetSeed () { return seed; }
+int DecisionTrace::GetEventCount () { return count; }
+unsigned DecisionTrace::GetDroppedCount () { return dropped; }
+
+TraceEvent DecisionTrace::GetEvent (int i) {
+	return events[(first + i) % CAPACITY];
+}
+
+bool DecisionTrace::Write (ostream & out) {
+	int32_t fileSeed = seed;
+	uint32_t fileCount = count;
+	uint32_t fileDropped = dropped;
+
+	out.write(TRACE_MAGIC, sizeof(TRACE_MAGIC));
+	out.write((const char *) &TRACE_FORMAT_VERSION, sizeof(TRACE_FORMAT_VERSION));
+	out.write((const char *) &fileSeed, sizeof(fileSeed));
+	out.write((const char *) &fileCount, sizeof(fileCount));
+	out.write((const char *) &fileDropped, sizeof(fileDropped));
+	for (int i = 0; i < count; i++) {
+		TraceEvent event = GetEvent(i);
+		out.write((const char *) &event, sizeof(event));
+	}
+
+	return !out.fail();
+}
+
+///////////////////////////////////////
+// MUTATORS
+///////////////////////////////////////
+
+void DecisionTrace::Record (TraceStage stage, int planet, int roll, int outcome, double value) {
+	TraceEvent event;
+	event.stage = stage;
+	event.planet = planet;
+	event.roll = roll;
+	event.outcome = outcome;
+	event.value = value;
+
+	if (count < CAPACITY) {
+		events[(first + count) % CAPACITY] = event;
+		count++;
+	}
+	else { // full: overwrite the oldest
+		events[first] = event;
+		first = (first + 1) % CAPACITY;
+		dropped++;
+	}
+}
+
+/* Read
+ * Replaces the contents with a trace written by Write
+ * Returns false if the stream does not hold a trace this version understands.
+ */
+bool DecisionTrace::Read (istream & in) {
+	char magic[4];
+	uint32_t version;
+	int32_t fileSeed;
+	uint32_t fileCount;
+	uint32_t fileDropped;
+
+	in.read(magic, sizeof(magic));
+	in.read((char *) &version, sizeof(version));
+	in.read((char *) &fileSeed, sizeof(fileSeed));
+	in.read((char *) &fileCount, sizeof(fileCount));
+	in.read((char *) &fileDropped, sizeof(fileDropped));
+	if (in.fail() || memcmp(magic, TRACE_MAGIC, sizeof(magic)) != 0 || version != TRACE_FORMAT_VERSION || fileCount > CAPACITY) {
+		return false;
+	}
+
+	seed = fileSeed;
+	first = 0;
+	count = 0;
+	dropped = fileDropped;
+	for (uint32_t i = 0; i < fileCount; i++) {
+		in.read((char *) &events[i], sizeof(TraceEvent));
+		if (in.fail()) { return false; }
+		count++;
+	}
+
+	return true;
+}
+
+///////////////////////////////////////
+// HELPERS
+///////////////////////////////////////
+
+void setActiveTrace (DecisionTrace * trace) {
+	activeTrace = trace;
+}
+
+string traceStageName (int stage) {
+	switch (stage) {
+		case TRACE_DISK_MASS_FACTOR: return "disk-mass-factor";
+		case TRACE_MIGRATION_FACTOR: return "migration-factor";
+		case TRACE_EXCLUSION_ZONE: return "exclusion-zone";
+		case TRACE_OUTER_SYSTEM_ROLL: return "outer-system-roll";
+		case TRACE_INWARD_MIGRATION: return "inward-migration";
+		case TRACE_GRAND_TACK_ROLL: return "grand-tack-roll";
+		case TRACE_GRAND_TACK_DISTANCE: return "grand-tack-distance";
+		case TRACE_NICE_ROLL: return "nice-roll";
+		case TRACE_INNER_MIGRATION_ROLL: return "inner-migration-roll";
+		case TRACE_PLANET_RESULT: return "planet-result";
+		case TRACE_DISK_HOST: return "disk-host";
+		default: return "unknown-" + to_string(stage);
+	}
+}
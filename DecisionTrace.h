@@ -0,0 +1,85 @@
+#ifndef DECISIONTRACE_H
+#define DECISIONTRACE_H
+
+#include <cstdint>
+#include <string>
+#include <iostream>
+using namespace std;
+
+/* TraceStage
+ * What an event records; see TraceDump.cpp for how each one is printed
+ * Values are stored in trace files, so only ever add to the end.
+ */
+enum TraceStage {
+	TRACE_DISK_MASS_FACTOR,     // value: factor
+	TRACE_MIGRATION_FACTOR,     // value: factor
+	TRACE_EXCLUSION_ZONE,       // planet marked inExclusionZone; value: distance
+	TRACE_OUTER_SYSTEM_ROLL,    // roll: 3d6 + modifier; outcome: modifier
+	TRACE_INWARD_MIGRATION,     // dominant gas giant moved; value: new distance
+	TRACE_GRAND_TACK_ROLL,      // roll: 3d6; outcome: 1 if the tack happened
+	TRACE_GRAND_TACK_DISTANCE,  // roll: 3d6; value: new distance
+	TRACE_NICE_ROLL,            // roll: 3d6; outcome: 1 if the planet was ejected
+	TRACE_INNER_MIGRATION_ROLL, // roll: 1d6; outcome: 1 if the planet was ejected
+	TRACE_PLANET_RESULT,        // roll: TRACE_FLAG_ bits; outcome: PlanetClass; value: distance
+	TRACE_DISK_HOST,            // a disk starts forming; roll: 1 if circumbinary; outcome: first star (0 is A); value: forbidden zone
+	TRACE_STAGE_COUNT
+};
+
+// flags recorded with TRACE_PLANET_RESULT
+const int TRACE_FLAG_EJECTED = 1;
+const int TRACE_FLAG_EXCLUDED = 2;
+const int TRACE_FLAG_DISRUPTED = 4;
+const int TRACE_FLAG_GRAND_TACK = 8;
+const int TRACE_FLAG_KEPT = 16;
+
+struct TraceEvent {
+	uint8_t stage;
+	int8_t planet; // -1 if the event is not about one planet
+	int16_t roll;
+	int32_t outcome;
+	float value;
+};
+
+/* DecisionTrace
+ * Fixed-size ring buffer of the dice rolls and decisions behind one system
+ * Once it is full the oldest events are overwritten and counted as dropped.
+ * Nothing is recorded unless a trace has been made active for the thread
+ * with setActiveTrace, so the TRACE_EVENT statements cost one branch otherwise.
+ * Files are "GSTR", format version, seed, event count and dropped count,
+ * then the events oldest first, all in host byte order.
+ */
+class DecisionTrace
+{
+	public:
+		static const int CAPACITY = 256;
+
+		// Constructors
+		DecisionTrace(int seed);
+		// Accessors
+		int GetSeed ();
+		int GetEventCount ();
+		unsigned GetDroppedCount ();
+		TraceEvent GetEvent (int i); // 0 is the oldest
+		bool Write (ostream & out);
+		// Mutators
+		void Record (TraceStage stage, int planet, int roll, int outcome, double value);
+		bool Read (istream & in);
+	protected:
+	private:
+		int seed;
+		TraceEvent events[CAPACITY];
+		int first; // oldest event
+		int count;
+		unsigned dropped;
+};
+
+// the trace that TRACE_EVENT records into on this thread, or null
+extern thread_local DecisionTrace * activeTrace;
+void setActiveTrace (DecisionTrace * trace);
+
+string traceStageName (int stage);
+
+#define TRACE_EVENT(stage, planet, roll, outcome, value) \
+	do { if (activeTrace != nullptr) { activeTrace->Record((stage), (planet), (roll), (outcome), (value)); } } while (0)
+
+#endif // DECISIONTRACE_H
@@ -0,0 +1,174 @@
+#ifndef DISTRIBUTIONS_H
+#define DISTRIBUTIONS_H
+
+#include <cmath>
+#include <cstddef>
+#include "RandomEngine.h"
+using namespace std;
+
+/* Distributions
+ * Stand-ins for the <random> distributions, whose algorithms the standard
+ * leaves to each library: the same seed gave different systems under
+ * libstdc++ and libc++.  Every algorithm here is fixed and documented:
+ *
+ *   uniformCanonical  [0, 1) from the engine's raw output.  A 64-bit engine
+ *                     gives one draw, top 53 bits, times 2^-53.  Any other
+ *                     engine gives two draws, (d0 + d1 * R) / R^2 with R its
+ *                     range, rounded down to just below 1 if it reaches 1.
+ *   UniformInt        a + floor(u * (b - a + 1)), u canonical
+ *   UniformReal       a + u * (b - a), u canonical
+ *   Normal            mean + stddev * z, z the inverse normal CDF (Wichura's
+ *                     AS241, accurate to about 1e-16) of u mapped into (0, 1)
+ *   LogNormal         exp(Normal(m, s))
+ *   TruncatedLogNormal
+ *                     LogNormal(m, s) given that it is at least a bound:
+ *                     z = -inverseNormalCdf(u * Q), Q the normal's upper
+ *                     tail above the bound, so no draws are ever rejected
+ *
+ * Every sample uses a fixed number of engine draws, with no rejection loops
+ * and no state carried between samples (unlike the polar method in
+ * libstdc++'s normal_distribution, which caches its second value).  So the
+ * draws can be made first and transformed afterwards in a separate, easily
+ * vectorised loop; see Fill.
+ *
+ * Only +, -, *, /, sqrt, log and exp are used, and log only in the normal's
+ * tails (|z| > 1.44).  The first five are exact under IEEE 754.  glibc and
+ * the other common C libraries return log and exp correctly rounded, so only
+ * a C library that does not could still change a result, by the last bit.
+ * The exception is the truncated log-normal's tail Q, which needs erfc; C
+ * libraries agree on it to an ulp or so, which can move its samples by as
+ * much in the last bit.
+ * This assumes the build does not contract a * b + c into fused
+ * multiply-adds; the standard-mode g++ build used by the Makefile does not.
+ */
+
+inline double uniformCanonical (RandomEngine & e) {
+	const double range = (double) RandomEngine::max() - (double) RandomEngine::min() + 1.0;
+	if (range >= 18446744073709551616.0) { // 2^64
+		return (double) ((uint64_t) (e() - RandomEngine::min()) >> 11) * 0x1.0p-53;
+	}
+	double low = (double) (e() - RandomEngine::min());
+	double high = (double) (e() - RandomEngine::min());
+	double u = (low + high * range) / (range * range);
+	return u < 1.0 ? u : 0x1.fffffffffffffp-1;
+}
+
+/* inverseNormalCdf
+ * Wichura, "Algorithm AS 241: The Percentage Points of the Normal
+ * Distribution", Applied Statistics 37 (1988), PPND16.  P must be in (0, 1).
+ */
+inline double inverseNormalCdf (double p) {
+	double q = p - 0.5;
+	if (fabs(q) <= 0.425) {
+		double r = 0.180625 - q * q;
+		return q * (((((((2509.0809287301226727 * r + 33430.575583588128105) * r + 67265.770927008700853) * r
+			+ 45921.953931549871457) * r + 13731.693765509461125) * r + 1971.5909503065514427) * r
+			+ 133.14166789178437745) * r + 3.387132872796366608)
+			/ (((((((5226.495278852545925 * r + 28729.085735721942674) * r + 39307.89580009271061) * r
+			+ 21213.794301586595867) * r + 5394.1960214247511077) * r + 687.1870074920579083) * r
+			+ 42.313330701600911252) * r + 1.0);
+	}
+
+	double r = (q < 0) ? p : 1.0 - p;
+	r = sqrt(-log(r));
+	double z;
+	if (r <= 5.0) {
+		r -= 1.6;
+		z = (((((((7.7454501427834140764e-4 * r + 0.0227238449892691845833) * r + 0.24178072517745061177) * r
+			+ 1.27045825245236838258) * r + 3.64784832476320460504) * r + 5.7694972214606914055) * r
+			+ 4.6303378461565452959) * r + 1.42343711074968357734)
+			/ (((((((1.05075007164441684324e-9 * r + 5.475938084995344946e-4) * r + 0.0151986665636164571966) * r
+			+ 0.14810397642748007459) * r + 0.68976733498510000455) * r + 1.6763848301838038494) * r
+			+ 2.05319162663775882187) * r + 1.0);
+	}
+	else {
+		r -= 5.0;
+		z = (((((((2.01033439929228813265e-7 * r + 2.71155556874348757815e-5) * r + 0.0012426609473880784386) * r
+			+ 0.026532189526576123093) * r + 0.29656057182850489123) * r + 1.7848265399172913358) * r
+			+ 5.4637849111641143699) * r + 6.6579046435011037772)
+			/ (((((((2.04426310338993978564e-15 * r + 1.4215117583164458887e-7) * r + 1.8463183175100546818e-5) * r
+			+ 7.868691311456132591e-4) * r + 0.0148753612908506148525) * r + 0.13692988092273580531) * r
+			+ 0.59983220655588793769) * r + 1.0);
+	}
+	return (q < 0) ? -z : z;
+}
+
+// canonical sample moved into the open interval (0, 1)
+inline double openUnit (double u) {
+	double p = u + 0x1.0p-54;
+	return p < 1.0 ? p : 0x1.fffffffffffffp-1;
+}
+
+class UniformIntDistribution
+{
+	public:
+		UniformIntDistribution(int low, int high) : a(low), span((double) high - low + 1.0) {}
+		int operator() (RandomEngine & e) { return a + (int) (uniformCanonical(e) * span); }
+	private:
+		int a;
+		double span;
+};
+
+class UniformRealDistribution
+{
+	public:
+		UniformRealDistribution(double low = 0.0, double high = 1.0) : a(low), width(high - low) {}
+		double operator() (RandomEngine & e) { return a + uniformCanonical(e) * width; }
+		void Fill (RandomEngine & e, double * out, size_t n) {
+			for (size_t i = 0; i < n; i++) { out[i] = uniformCanonical(e); }
+			for (size_t i = 0; i < n; i++) { out[i] = a + out[i] * width; }
+		}
+	private:
+		double a;
+		double width;
+};
+
+class NormalDistribution
+{
+	public:
+		NormalDistribution(double m = 0.0, double s = 1.0) : mean(m), stddev(s) {}
+		double operator() (RandomEngine & e) { return mean + stddev * inverseNormalCdf(openUnit(uniformCanonical(e))); }
+		void Fill (RandomEngine & e, double * out, size_t n) {
+			for (size_t i = 0; i < n; i++) { out[i] = uniformCanonical(e); }
+			for (size_t i = 0; i < n; i++) { out[i] = mean + stddev * inverseNormalCdf(openUnit(out[i])); }
+		}
+	private:
+		double mean;
+		double stddev;
+};
+
+class LogNormalDistribution
+{
+	public:
+		LogNormalDistribution(double m = 0.0, double s = 1.0) : normal(m, s) {}
+		double operator() (RandomEngine & e) { return exp(normal(e)); }
+	private:
+		NormalDistribution normal;
+};
+
+/* TruncatedLogNormalDistribution
+ * LogNormal(m, s) restricted to values of at least LOW; LOW of 0 or less
+ * restricts nothing.  A LOW so far out in the tail that Q underflows gives
+ * LOW itself.
+ */
+class TruncatedLogNormalDistribution
+{
+	public:
+		TruncatedLogNormalDistribution(double m, double s, double low) : mean(m), stddev(s), minimum(low) {
+			double lowZ = (low > 0) ? (log(low) - m) / s : -HUGE_VAL;
+			tail = 0.5 * erfc(lowZ * 0.70710678118654752440); // P(Z >= lowZ)
+		}
+		double operator() (RandomEngine & e) {
+			double u = openUnit(uniformCanonical(e));
+			if (!(tail > 1e-300)) { return minimum; }
+			double x = exp(mean - stddev * inverseNormalCdf(u * tail));
+			return (x > minimum) ? x : minimum;
+		}
+	private:
+		double mean;
+		double stddev;
+		double minimum;
+		double tail;
+};
+
+#endif // DISTRIBUTIONS_H
@@ -0,0 +1,164 @@
+#include <cmath>
+#include <vector>
+#include "EvolutionGrid.h"
+#include "Generator.h"
+using namespace std;
+
+// star masses: the regressions' breakpoints, each segment cut into equal
+// steps of log mass
+const int MASS_SEGMENTS = 5;
+const double SEGMENT_BOUNDS[MASS_SEGMENTS + 1] = { 0.08, 0.43, 0.5, 1.3, 2.0, 2.2 };
+const int CELLS_PER_SEGMENT = 128;
+const int MASS_NODES = MASS_SEGMENTS * (CELLS_PER_SEGMENT + 1);
+
+// main-sequence age, linear
+const double MAX_AGE = 13.5;
+const int AGE_CELLS = 27;
+
+// brown dwarfs and white dwarfs, by log age; 1 Ma to 13.5 Ga
+const double MIN_LOG_AGE = log(0.001);
+const double MAX_LOG_AGE = log(13.5);
+const int LOG_AGE_CELLS = 27;
+
+const double MIN_BROWN_DWARF_MASS = 0.01;
+const double MAX_BROWN_DWARF_MASS = 0.08;
+const int BROWN_DWARF_CELLS = 16;
+
+EvolutionGrid::EvolutionGrid()
+{
+	logLifespan.resize(MASS_NODES);
+	logInitialLuminosity.resize(MASS_NODES);
+	initialTemperature.resize(MASS_NODES);
+	logMainSequenceLuminosity.resize(MASS_NODES * (AGE_CELLS + 1));
+	logWhiteDwarfTemperature.resize(MASS_NODES * (LOG_AGE_CELLS + 1));
+	logBrownDwarfTemperature.resize((BROWN_DWARF_CELLS + 1) * (LOG_AGE_CELLS + 1));
+
+	for (int s = 0; s < MASS_SEGMENTS; s++) {
+		double low = SEGMENT_BOUNDS[s];
+		double high = SEGMENT_BOUNDS[s + 1];
+		double step = (log(high) - log(low)) / CELLS_PER_SEGMENT;
+		for (int j = 0; j <= CELLS_PER_SEGMENT; j++) {
+			// the end nodes take the formula from inside the segment
+			double mass;
+			if (j == 0) { mass = nextafter(low, high); }
+			else if (j == CELLS_PER_SEGMENT) { mass = nextafter(high, low); }
+			else { mass = exp(log(low) + j * step); }
+
+			int node = s * (CELLS_PER_SEGMENT + 1) + j;
+			double lifespan = getStellarLifespan(mass);
+			logLifespan[node] = log(lifespan);
+			logInitialLuminosity[node] = log(getInitialLuminosity(mass));
+			initialTemperature[node] = getInitialTemperature(mass);
+
+			// as in evolveStar: L = L0 * 2.2^(age / lifespan)
+			for (int a = 0; a <= AGE_CELLS; a++) {
+				double age = a * MAX_AGE / AGE_CELLS;
+				logMainSequenceLuminosity[node * (AGE_CELLS + 1) + a] = logInitialLuminosity[node] + log(2.2) * age / lifespan;
+			}
+
+			// as in evolveStar: T = 13500 * M^0.25 / t^0.35, M the remnant's mass
+			double remnantMass = 0.43 + mass / 10.4;
+			for (int a = 0; a <= LOG_AGE_CELLS; a++) {
+				double logAge = MIN_LOG_AGE + a * (MAX_LOG_AGE - MIN_LOG_AGE) / LOG_AGE_CELLS;
+				logWhiteDwarfTemperature[node * (LOG_AGE_CELLS + 1) + a] = log(13500.0) + 0.25 * log(remnantMass) - 0.35 * logAge;
+			}
+		}
+	}
+
+	// as in evolveStar: T = 18600 * M^0.83 / t^0.32
+	double brownDwarfStep = (log(MAX_BROWN_DWARF_MASS) - log(MIN_BROWN_DWARF_MASS)) / BROWN_DWARF_CELLS;
+	for (int j = 0; j <= BROWN_DWARF_CELLS; j++) {
+		double logMass = log(MIN_BROWN_DWARF_MASS) + j * brownDwarfStep;
+		for (int a = 0; a <= LOG_AGE_CELLS; a++) {
+			double logAge = MIN_LOG_AGE + a * (MAX_LOG_AGE - MIN_LOG_AGE) / LOG_AGE_CELLS;
+			logBrownDwarfTemperature[j * (LOG_AGE_CELLS + 1) + a] = log(18600.0) + 0.83 * logMass - 0.32 * logAge;
+		}
+	}
+}
+
+///////////////////////////////////////
+// ACCESSORS
+///////////////////////////////////////
+
+/* LocateStar
+ * Finds the mass's segment, then its cell within the segment
+ */
+EvolutionGrid::Cell EvolutionGrid::LocateStar (double mass) const {
+	static const double logBounds[MASS_SEGMENTS + 1] = {
+		log(SEGMENT_BOUNDS[0]), log(SEGMENT_BOUNDS[1]), log(SEGMENT_BOUNDS[2]),
+		log(SEGMENT_BOUNDS[3]), log(SEGMENT_BOUNDS[4]), log(SEGMENT_BOUNDS[5])
+	};
+
+	double logMass = log(mass);
+	int s = 0;
+	while (s < MASS_SEGMENTS - 1 && logMass >= logBounds[s + 1]) { s++; }
+	double step = (logBounds[s + 1] - logBounds[s]) / CELLS_PER_SEGMENT;
+	Cell c = Locate(logMass, logBounds[s], step, CELLS_PER_SEGMENT);
+	c.left += s * (CELLS_PER_SEGMENT + 1);
+	return c;
+}
+
+double EvolutionGrid::GetLifespan (Cell mass) const {
+	return exp(logLifespan[mass.left] + mass.t * (logLifespan[mass.left + 1] - logLifespan[mass.left]));
+}
+
+double EvolutionGrid::GetInitialLuminosity (Cell mass) const {
+	return exp(logInitialLuminosity[mass.left] + mass.t * (logInitialLuminosity[mass.left + 1] - logInitialLuminosity[mass.left]));
+}
+
+double EvolutionGrid::GetInitialTemperature (Cell mass) const {
+	return initialTemperature[mass.left] + mass.t * (initialTemperature[mass.left + 1] - initialTemperature[mass.left]);
+}
+
+double EvolutionGrid::GetMainSequenceLuminosity (Cell mass, double age) const {
+	Cell a = Locate(age, 0, MAX_AGE / AGE_CELLS, AGE_CELLS);
+	return exp(Bilinear(logMainSequenceLuminosity, AGE_CELLS + 1, mass, a));
+}
+
+/* GetWhiteDwarfTemperature
+ * MASS is the star's cell from before it shed its envelope
+ */
+double EvolutionGrid::GetWhiteDwarfTemperature (Cell mass, double coolingAge) const {
+	Cell a = Locate(log(coolingAge), MIN_LOG_AGE, (MAX_LOG_AGE - MIN_LOG_AGE) / LOG_AGE_CELLS, LOG_AGE_CELLS);
+	return exp(Bilinear(logWhiteDwarfTemperature, LOG_AGE_CELLS + 1, mass, a));
+}
+
+double EvolutionGrid::GetBrownDwarfTemperature (double mass, double age) const {
+	Cell m = Locate(log(mass), log(MIN_BROWN_DWARF_MASS), (log(MAX_BROWN_DWARF_MASS) - log(MIN_BROWN_DWARF_MASS)) / BROWN_DWARF_CELLS, BROWN_DWARF_CELLS);
+	Cell a = Locate(log(age), MIN_LOG_AGE, (MAX_LOG_AGE - MIN_LOG_AGE) / LOG_AGE_CELLS, LOG_AGE_CELLS);
+	return exp(Bilinear(logBrownDwarfTemperature, LOG_AGE_CELLS + 1, m, a));
+}
+
+///////////////////////////////////////
+// HELPERS
+///////////////////////////////////////
+
+/* Locate
+ * The cell of an axis of CELLS equal steps from LOW that holds X, clamped to
+ * the first or last cell so that points off the ends extrapolate
+ */
+EvolutionGrid::Cell EvolutionGrid::Locate (double x, double low, double step, int cells) {
+	double position = (x - low) / step;
+	Cell c;
+	if (!(position > 0)) { c.left = 0; } // also catches NaN
+	else if (position >= cells - 1) { c.left = cells - 1; }
+	else { c.left = (int) position; }
+	c.t = position - c.left;
+	return c;
+}
+
+double EvolutionGrid::Bilinear (const vector<double> & grid, int columns, Cell row, Cell column) {
+	const double * top = &grid[row.left * columns + column.left];
+	const double * bottom = top + columns;
+	double upper = top[0] + column.t * (top[1] - top[0]);
+	double lower = bottom[0] + column.t * (bottom[1] - bottom[0]);
+	return upper + row.t * (lower - upper);
+}
+
+/* getEvolutionGrid
+ * The grid is built on first use, once per process
+ */
+const EvolutionGrid & getEvolutionGrid () {
+	static const EvolutionGrid grid;
+	return grid;
+}
@@ -0,0 +1,66 @@
+#ifndef EVOLUTIONGRID_H
+#define EVOLUTIONGRID_H
+
+#include <vector>
+using namespace std;
+
+/* EvolutionGrid
+ * The deterministic parts of stellar evolution, tabulated once so that
+ * evolveStar interpolates instead of calling pow, exp and log.  Built from
+ * getInitialLuminosity, getStellarLifespan, getInitialTemperature and the
+ * brown and white dwarf formulas in evolveStar, over:
+ *   - stars, 0.08 to 2.2 solar masses: lifespan, initial luminosity and
+ *     temperature by mass, and main-sequence luminosity by mass and age
+ *     (0 to 13.5 Ga)
+ *   - brown dwarfs, 0.01 to 0.08 solar masses: temperature by mass and age
+ *   - white dwarfs: temperature by progenitor mass and time since the star
+ *     left the giant branch
+ *
+ * Mass is tabulated by log mass, and every value is kept in the form the
+ * formulas make linear in the axes where they can: log luminosity is linear
+ * in age on the main sequence, and the dwarf temperatures are power laws, so
+ * their logs are linear in log mass and log age.  Interpolation along those
+ * axes is then exact, and bilinear lookup only approximates the mass
+ * dependence of the main sequence and of the white dwarf masses.  The
+ * regressions change formula at 0.43, 0.5, 1.3 and 2.0 solar masses, so the
+ * mass axis is split there and each segment is tabulated from its own side.
+ * Lookups outside the grid extrapolate from the nearest cell.
+ *
+ * A star's mass is located once, with LocateStar, and the cell it returns
+ * passed to each lookup for that star.
+ */
+class EvolutionGrid
+{
+	public:
+		// a point on an axis: the node before it and how far it is towards the next
+		struct Cell {
+			int left;
+			double t;
+		};
+
+		// Constructors
+		EvolutionGrid();
+		// Accessors
+		Cell LocateStar (double mass) const;
+		double GetLifespan (Cell mass) const;
+		double GetInitialLuminosity (Cell mass) const;
+		double GetInitialTemperature (Cell mass) const;
+		double GetMainSequenceLuminosity (Cell mass, double age) const;
+		double GetWhiteDwarfTemperature (Cell mass, double coolingAge) const;
+		double GetBrownDwarfTemperature (double mass, double age) const;
+	protected:
+	private:
+		static Cell Locate (double x, double low, double step, int cells);
+		static double Bilinear (const vector<double> & grid, int columns, Cell row, Cell column);
+
+		vector<double> logLifespan;        // by mass node
+		vector<double> logInitialLuminosity;
+		vector<double> initialTemperature;
+		vector<double> logMainSequenceLuminosity; // by mass node, then age node
+		vector<double> logWhiteDwarfTemperature;  // by mass node, then cooling age node
+		vector<double> logBrownDwarfTemperature;  // by brown dwarf mass node, then age node
+};
+
+const EvolutionGrid & getEvolutionGrid ();
+
+#endif // EVOLUTIONGRID_H
@@ -0,0 +1,60 @@
+#ifndef FIXEDVECTOR_H
+#define FIXEDVECTOR_H
+
+#include <cstddef>
+#include <cassert>
+#include <new>
+#include <utility>
+using namespace std;
+
+/* FixedVector
+ * A vector with room for N elements inside the object itself, for the few
+ * places that always hold about the same small number of things (the twelve
+ * formation slots of a disk).  It never touches the heap, elements stay
+ * where they are, and emplace_back builds each one in place.  Every index
+ * and every addition is checked with assert, so a stray index stops a debug
+ * build at the line that made it instead of quietly writing over a
+ * neighbour; built with -DNDEBUG the checks cost nothing.
+ */
+template <typename T, size_t N>
+class FixedVector
+{
+	public:
+		// Constructors
+		FixedVector() {}
+		~FixedVector() { clear(); }
+		FixedVector(const FixedVector &) = delete;
+		FixedVector & operator= (const FixedVector &) = delete;
+		// Accessors
+		size_t size () const { return count; }
+		static constexpr size_t capacity () { return N; }
+		bool empty () const { return count == 0; }
+		const T & operator[] (size_t i) const { assert(i < count); return data()[i]; }
+		const T * begin () const { return data(); }
+		const T * end () const { return data() + count; }
+		// Mutators
+		T & operator[] (size_t i) { assert(i < count); return data()[i]; }
+		T * begin () { return data(); }
+		T * end () { return data() + count; }
+		template <typename... Args>
+		T & emplace_back (Args &&... args) {
+			assert(count < N);
+			T * item = new (data() + count) T(forward<Args>(args)...);
+			count++;
+			return *item;
+		}
+		void push_back (const T & item) { emplace_back(item); }
+		void push_back (T && item) { emplace_back(move(item)); }
+		void clear () {
+			for (size_t i = 0; i < count; i++) { data()[i].~T(); }
+			count = 0;
+		}
+	private:
+		T * data () { return reinterpret_cast<T *>(storage); }
+		const T * data () const { return reinterpret_cast<const T *>(storage); }
+
+		alignas(T) unsigned char storage[N * sizeof(T)];
+		size_t count = 0;
+};
+
+#endif // FIXEDVECTOR_H
@@ -0,0 +1,259 @@
+#include <vector>
+#include <string>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <system_error>
+#include "FormationPipeline.h"
+#include "SystemArena.h"
+#include "Log.h"
+#include "RandomEngine.h"
+using namespace std;
+
+// Function declarations
+void runDiskStage (DiskJob * jobs, size_t count);
+void runOuterSystemStage (DiskJob * jobs, size_t count);
+void runMigrationStage (DiskJob * jobs, size_t count);
+void runInnerSystemStage (DiskJob * jobs, size_t count);
+void runPlanetsStage (DiskJob * jobs, size_t count);
+void runMoonsStage (DiskJob * jobs, size_t count);
+void runOrbitsStage (DiskJob * jobs, size_t count);
+void runRotationStage (DiskJob * jobs, size_t count);
+void runSurfaceStage (DiskJob * jobs, size_t count);
+struct FormationWorkers;
+FormationWorkers & formationWorkers ();
+void formationWorker (FormationWorkers * workers, size_t index);
+
+const Pipeline & generationPipeline () {
+	static const Pipeline stages = {
+		{ "disk", runDiskStage },
+		{ "outer system", runOuterSystemStage },
+		{ "migration", runMigrationStage },
+		{ "inner system", runInnerSystemStage },
+		{ "planets", runPlanetsStage },
+		{ "moons", runMoonsStage },
+		{ "orbits", runOrbitsStage },
+		{ "rotation", runRotationStage },
+		{ "surface", runSurfaceStage }
+	};
+	return stages;
+}
+
+const Pipeline & evolutionPipeline () {
+	static const Pipeline stages = {
+		{ "orbits", runOrbitsStage },
+		{ "rotation", runRotationStage },
+		{ "surface", runSurfaceStage }
+	};
+	return stages;
+}
+
+/* replaceStage
+ * Has the stage called NAME run RUN instead
+ * Returns false, leaving PIPELINE as it was, if there is no such stage.
+ */
+bool replaceStage (Pipeline & pipeline, const string & name, StageRunner run) {
+	for (size_t s = 0; s < pipeline.size(); s++) {
+		if (name == pipeline[s].name) {
+			pipeline[s].run = run;
+			return true;
+		}
+	}
+	return false;
+}
+
+/* runPipeline
+ * Runs each stage over all COUNT jobs before the next.  If STAGESECONDS
+ * is not null, each stage's time is added to its entry (one per stage).
+ */
+void runPipeline (const Pipeline & pipeline, DiskJob * jobs, size_t count, double * stageSeconds) {
+	for (size_t s = 0; s < pipeline.size(); s++) {
+		if (stageSeconds == nullptr) {
+			pipeline[s].run(jobs, count);
+			continue;
+		}
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		pipeline[s].run(jobs, count);
+		stageSeconds[s] += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	}
+}
+
+// a system has at most four stars, so at most four disks: the caller's and three more
+const size_t FORMATION_WORKERS = 3;
+
+/* FormationWorkers
+ * The threads runPipelineOnWorkers hands disks to.  They are started with
+ * the first system that needs them and wait for the next one for the rest
+ * of the run, so forming a multiple system starts no thread and allocates
+ * nothing.  Each keeps its LOG output in a buffer of its own, which keeps
+ * its room from one disk to the next, and adds the random draws its disk
+ * took to the round's, which the system's thread then counts as its own.
+ */
+struct FormationWorkers {
+	size_t started = 0;         // threads that could be started
+	mutex claim;                // held by the system whose disks the workers have
+	mutex lock;                 // guards the rest
+	condition_variable wake;
+	condition_variable done;
+	unsigned long round = 0;    // counts the systems handed out
+	size_t pending = 0;         // disks of this round not finished yet
+	unsigned long long draws = 0;   // random draws the workers took this round
+	const Pipeline * pipeline = nullptr;
+	DiskJob * jobs[FORMATION_WORKERS] = {};        // null for a worker with nothing to do this round
+	ArenaStringBuf * logs[FORMATION_WORKERS] = {};
+};
+
+/* runPipelineOnWorkers
+ * Runs PIPELINE over the COUNT jobs at once, the first on this thread and
+ * each of the others on a formation worker, then writes the workers' LOG
+ * output after this thread's, in job order, and adds the draws they took to
+ * this thread's randomDrawCount.
+ * Returns false, having run nothing, if the workers are busy with another
+ * system or there are more jobs than workers; the caller then runs the jobs
+ * itself.
+ */
+bool runPipelineOnWorkers (const Pipeline & pipeline, DiskJob * jobs, size_t count) {
+	FormationWorkers & w = formationWorkers();
+	if (count == 0 || count - 1 > w.started) { return false; }
+	unique_lock<mutex> claim(w.claim, try_to_lock);
+	if (!claim.owns_lock()) { return false; }
+
+	{
+		lock_guard<mutex> guard(w.lock);
+		w.pipeline = &pipeline;
+		for (size_t h = 0; h < FORMATION_WORKERS; h++) {
+			w.jobs[h] = (h + 1 < count) ? &jobs[h + 1] : nullptr;
+		}
+		w.pending = count - 1;
+		w.draws = 0;
+		w.round++;
+	}
+	w.wake.notify_all();
+
+	runPipeline(pipeline, &jobs[0], 1, nullptr);
+
+	unique_lock<mutex> guard(w.lock);
+	w.done.wait(guard, [&w]() { return w.pending == 0; });
+	randomDrawCount += w.draws;
+	for (size_t h = 0; h + 1 < count; h++) {
+		logStream() << w.logs[h]->GetText();
+	}
+	return true;
+}
+
+///////////////////////////////////////
+// HELPERS
+///////////////////////////////////////
+
+/* formationWorkers
+ * The workers, started on first use and never stopped; a thread that cannot
+ * be started leaves the rest to run systems with fewer disks
+ */
+FormationWorkers & formationWorkers () {
+	static FormationWorkers * workers = []() {
+		FormationWorkers * w = new FormationWorkers();
+		for (size_t h = 0; h < FORMATION_WORKERS; h++) {
+			try {
+				thread(formationWorker, w, h).detach();
+			}
+			catch (const system_error &) {
+				break;
+			}
+			w->started++;
+		}
+		return w;
+	}();
+	return *workers;
+}
+
+/* formationWorker
+ * Worker INDEX of WORKERS: runs the pipeline over the job it is given each
+ * round, if any.  Its log buffer is made here, outside any ArenaScope, so
+ * it comes from the heap and never from the arena of the thread that hands
+ * out the jobs.
+ */
+void formationWorker (FormationWorkers * workers, size_t index) {
+	ArenaStringBuf buffer;
+	ostream log(&buffer);
+	setLogStream(log);
+
+	FormationWorkers & w = *workers;
+	unique_lock<mutex> guard(w.lock);
+	w.logs[index] = &buffer;
+	unsigned long seen = 0;
+	while (true) {
+		w.wake.wait(guard, [&]() { return w.round != seen; });
+		seen = w.round;
+		DiskJob * job = w.jobs[index];
+		if (job == nullptr) { continue; }
+
+		guard.unlock();
+		buffer.Clear();
+		unsigned long long draws = randomDrawCount;
+		runPipeline(*w.pipeline, job, 1, nullptr);
+		guard.lock();
+		w.draws += randomDrawCount - draws;
+		if (--w.pending == 0) { w.done.notify_one(); }
+	}
+}
+
+void runDiskStage (DiskJob * jobs, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		DiskJob & j = jobs[i];
+		j.conditions = setUpDisk(*j.disk, j.seed, j.component, j.slots);
+	}
+}
+
+void runOuterSystemStage (DiskJob * jobs, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		DiskJob & j = jobs[i];
+		j.massToInnerSystem = formOuterSystem(j.slots, j.seed, j.component);
+	}
+}
+
+void runMigrationStage (DiskJob * jobs, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		DiskJob & j = jobs[i];
+		j.migration = migrateGiants(*j.disk, j.conditions, j.slots, j.seed, j.component);
+	}
+}
+
+void runInnerSystemStage (DiskJob * jobs, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		DiskJob & j = jobs[i];
+		formInnerSystem(*j.disk, j.conditions, j.massToInnerSystem, j.migration, j.slots, j.seed, j.component);
+	}
+}
+
+void runPlanetsStage (DiskJob * jobs, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		DiskJob & j = jobs[i];
+		settlePlanets(j.slots, j.migration, *j.disk, j.seed, j.component);
+	}
+}
+
+void runMoonsStage (DiskJob * jobs, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		DiskJob & j = jobs[i];
+		formMoons(*j.disk, j.conditions, j.seed, j.component);
+	}
+}
+
+void runOrbitsStage (DiskJob * jobs, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		setOrbitalPeriods(*jobs[i].disk);
+	}
+}
+
+void runRotationStage (DiskJob * jobs, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		setRotation(*jobs[i].disk, jobs[i].seed, jobs[i].component);
+	}
+}
+
+void runSurfaceStage (DiskJob * jobs, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		setSurfaces(*jobs[i].disk, jobs[i].seed, jobs[i].component);
+	}
+}
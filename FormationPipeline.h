@@ -0,0 +1,98 @@
+#ifndef FORMATIONPIPELINE_H
+#define FORMATIONPIPELINE_H
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include "Planet.h"
+#include "StarSystem.h"
+#include "FixedVector.h"
+using namespace std;
+
+// struct for planet formation
+struct FormingPlanet {
+	Planet planet;
+	bool isDominantGasGiant = false;
+	bool inExclusionZone = false;
+	bool lastBeforeSlowAccretion = false;
+	bool penultBeforeSlowAccretion = false;
+	bool orbitDisrupted = false;
+	bool triggeredGrandTack = false;
+	bool planetEjected = false;
+	bool finalPlacement = false;
+};
+// every disk starts with the same twelve slots, temp0 to temp11
+typedef FixedVector<FormingPlanet, 12> FormationSlots;
+
+/* DiskConditions
+ * What the "disk" stage works out from the disk's mass and its host, for
+ * the stages after it
+ */
+struct DiskConditions {
+	double diskMassFactor = 0.0;
+	double migrationFactor = 0.0;
+	double diskInnerEdge = 0.0;
+	double slowAccretionLine = 0.0;
+	double innerFormationZone = 0.0;  // before the outer system sends any mass in
+	double middleFormationZone = 0.0;
+	double outerFormationZone = 0.0;
+};
+
+/* GiantMigration
+ * What the "migration" stage leaves for the inner system and the disk
+ */
+struct GiantMigration {
+	int dominantGasGiantIndex = -1;   // -1 if no gas giant formed
+	bool grandTack = false;
+};
+
+/* DiskJob
+ * One disk on its way through the pipeline: which disk it is, and each
+ * stage's output for the stages after it.  The slots are worked on from the
+ * "disk" stage to the "inner system" stage, and the "planets" stage moves
+ * the survivors into the disk.
+ */
+struct DiskJob {
+	PlanetarySystem * disk = nullptr;
+	int seed = 0;
+	int component = 0;                // the star whose streams the disk draws from
+	FormationSlots slots;
+	DiskConditions conditions;        // "disk"
+	double massToInnerSystem = 0.0;   // "outer system"
+	GiantMigration migration;         // "migration"
+};
+
+/* PipelineStage
+ * One step of planet generation, run over every disk of a batch before the
+ * next step starts, so that each step's code and tables stay in cache.  A
+ * stage may be replaced by any function that does the same job for the
+ * whole batch at once (with SystemBatch, say).
+ */
+typedef void (*StageRunner) (DiskJob * jobs, size_t count);
+struct PipelineStage {
+	const char * name;
+	StageRunner run;
+};
+typedef vector<PipelineStage> Pipeline;
+
+// planet generation, stage by stage: "disk", "outer system",
+// "migration", "inner system", "planets", "moons", "orbits", "rotation", "surface"
+const Pipeline & generationPipeline ();
+// "orbits", "rotation" and "surface", as EvolveSystem runs them
+const Pipeline & evolutionPipeline ();
+bool replaceStage (Pipeline & pipeline, const string & name, StageRunner run);
+void runPipeline (const Pipeline & pipeline, DiskJob * jobs, size_t count, double * stageSeconds);
+bool runPipelineOnWorkers (const Pipeline & pipeline, DiskJob * jobs, size_t count);
+
+// The stages themselves, one disk at a time (Generator.cpp)
+DiskConditions setUpDisk (const PlanetarySystem & disk, int seed, int component, FormationSlots & slots);
+double formOuterSystem (FormationSlots & slots, int seed, int component);
+GiantMigration migrateGiants (const PlanetarySystem & disk, const DiskConditions & conditions, FormationSlots & slots, int seed, int component);
+void formInnerSystem (const PlanetarySystem & disk, const DiskConditions & conditions, double massToInnerSystem, const GiantMigration & migration, FormationSlots & slots, int seed, int component);
+void settlePlanets (FormationSlots & slots, const GiantMigration & migration, PlanetarySystem & disk, int seed, int component);
+void formMoons (PlanetarySystem & disk, const DiskConditions & conditions, int seed, int component);
+void setOrbitalPeriods (PlanetarySystem & disk);
+void setRotation (PlanetarySystem & disk, int seed, int component);
+void setSurfaces (PlanetarySystem & disk, int seed, int component);
+
+#endif // FORMATIONPIPELINE_H
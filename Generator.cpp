@@ -0,0 +1,1960 @@
+#include <iostream>
+#include <array>
+#include <vector>
+#include <random>
+#include <string>
+#include <cmath>            // ceil
+#include <atomic>
+#include "Star.h"
+#include "Planet.h"
+#include "Moon.h"
+#include "StarSystem.h"
+#include "Generator.h"
+#include "Log.h"
+#include "DecisionTrace.h"
+#include "Distributions.h"
+#include "AliasTable.h"
+#include "EvolutionGrid.h"
+#include "FixedVector.h"
+#include "FormationPipeline.h"
+#include "Profiler.h"
+#include "useful.cpp"
+using namespace std;
+
+void placeRemainingPlanets (FormationSlots & pVector, int firstPlanetIndex, int lastPlanetIndex, int countToBePlaced, RandomEngine & e);
+void findDisks (StarSystem & system, int node);
+void setHostStar (StarSystem & system, PlanetarySystem & disk);
+void logFinalLayout (StarSystem & system);
+
+/* GenerateSystem
+ * Generates the stars and planets of one system from its seed
+ * Nothing is written anywhere except the LOG diagnostics; see
+ * WriteSystemHtml for rendering the result.
+ */
+StarSystem GenerateSystem (int seed, GenerationOptions options) {
+	ProfileDraws draws(DRAWS_SYSTEM, seed);
+	StarSystem system = GenerateStars(seed, options);
+	formPlanetarySystems(&system, 1, generationPipeline(), nullptr);
+	return system;
+}
+
+/* GenerateSystems
+ * GenerateSystem for COUNT seeds at once: the stars of each, then the
+ * planets of them all through the pipeline, each stage over every disk
+ * before the next.  The systems are the same as GenerateSystem's.
+ */
+pmr::vector<StarSystem> GenerateSystems (const int * seeds, size_t count, GenerationOptions options) {
+	pmr::vector<StarSystem> systems(systemMemory());
+	systems.reserve(count);
+	for (size_t i = 0; i < count; i++) {
+		systems.push_back(GenerateStars(seeds[i], options));
+	}
+	formPlanetarySystems(systems.data(), count, generationPipeline(), nullptr);
+	return systems;
+}
+
+/* GenerateStars
+ * The stellar stage of GenerateSystem on its own: masses, multiplicity,
+ * orbits, age, metallicity and the evolved stars, with no planets.  The
+ * stars are the same as in the full system for the same seed.
+ */
+StarSystem GenerateStars (int seed, GenerationOptions options) {
+	ProfileTimer timer(PROFILE_STARS);
+	ProfileDraws draws(DRAWS_STARS, seed);
+	StarSystem system;
+	system.seed = seed;
+
+	// each stage draws from its own stream; see makeStream
+	RandomEngine primaryEngine = makeStream(seed, 0, -1, STAGE_PRIMARY);
+	RandomEngine companionEngine = makeStream(seed, -1, -1, STAGE_COMPANIONS);
+	RandomEngine ageEngine = makeStream(seed, -1, -1, STAGE_AGE);
+
+	// mass of the primary star
+	double baseMass = initialMassFunction(primaryEngine);
+	//baseMass = 1.02; // for testing
+	LOG(LOG_DEBUG) << "baseMass: " << baseMass << "\n";
+
+	bool isMultiple = isSystemMultiple(baseMass, primaryEngine);
+
+	// Create star
+	int a = system.AddStar(Star(baseMass));
+
+	// If the star is multiple, determine components
+	if (isMultiple) {
+		int multiplicity = generateSystemMultiplicity(companionEngine);
+		//multiplicity = 4; // for testing
+
+		if (multiplicity == 2) {
+			double massRatio = generateMassRatio(companionEngine);
+			int b = system.AddStar(Star(baseMass * massRatio));
+
+			OverallSeparation orbitAB;
+			orbitAB.separation = generateDistanceBetweenStars(companionEngine, baseMass);
+			orbitAB.eccentricity = generateMultipleStarEccentricity(companionEngine, orbitAB.separation);
+			system.AddPair(a, b, orbitAB);
+		}
+		else if (multiplicity == 3) {
+			// flip coin; if heads, C orbits AB, else BC orbits A
+			bool cOrbitsAB = flipCoin(companionEngine);
+
+			// C orbits close pair AB
+			if (cOrbitsAB) {
+				double massRatioAB = generateHeavyMassRatio(companionEngine);
+				double massRatioAC = generateMassRatio(companionEngine);
+				int b = system.AddStar(Star(baseMass * massRatioAB));
+				int c = system.AddStar(Star(baseMass * massRatioAC));
+
+				OverallSeparation orbitAB;
+				orbitAB.separation = generateDistanceBetweenStars(companionEngine, baseMass);
+				orbitAB.eccentricity = generateMultipleStarEccentricity(companionEngine, orbitAB.separation);
+				int ab = system.AddPair(a, b, orbitAB);
+
+				// C's periastron must clear AB's exclusion zone, so the
+				// eccentricity is drawn first and the separation from beyond
+				// what that allows
+				double exclusionZoneAB = getOuterOrbitalExclusionZone(baseMass, baseMass * massRatioAB, orbitAB.separation, orbitAB.eccentricity);
+				OverallSeparation orbitABC;
+				orbitABC.eccentricity = generateWideOrbitEccentricity(companionEngine);
+				orbitABC.separation = generateDistanceBeyond(companionEngine, baseMass, exclusionZoneAB / (1 - orbitABC.eccentricity));
+				//orbitABC.separation = 25; // for testing
+				if (orbitABC.separation <= 0.2) { orbitABC.eccentricity = 0.0; } // as generateMultipleStarEccentricity
+				system.AddPair(ab, c, orbitABC);
+			}
+			// A orbits close pair BC
+			else {
+				double massRatioAB = generateMassRatio(companionEngine);
+				double massRatioBC = generateHeavyMassRatio(companionEngine);
+				int b = system.AddStar(Star(baseMass * massRatioAB));
+				int c = system.AddStar(Star(baseMass * massRatioAB * massRatioBC));
+
+				OverallSeparation orbitBC;
+				orbitBC.separation = generateDistanceBetweenStars(companionEngine, baseMass * massRatioAB);
+				orbitBC.eccentricity = generateMultipleStarEccentricity(companionEngine, orbitBC.separation);
+				int bc = system.AddPair(b, c, orbitBC);
+
+				// Set separation of A(BC)
+				OverallSeparation orbitABC;
+				orbitABC.separation = generateDistanceBeyond(companionEngine, baseMass, 3 * (orbitBC.separation * (1 + orbitBC.eccentricity)));
+				orbitABC.eccentricity = generateMultipleStarEccentricity(companionEngine, orbitABC.separation);
+				system.AddPair(a, bc, orbitABC);
+			} // close A orbits close pair BC
+		} // close trinary
+		else { // quaternary: pairs AB and CD
+			double massRatioAB = generateHeavyMassRatio(companionEngine);
+			int b = system.AddStar(Star(baseMass * massRatioAB));
+
+			OverallSeparation orbitAB;
+			orbitAB.separation = generateDistanceBetweenStars(companionEngine, baseMass);
+			orbitAB.eccentricity = generateMultipleStarEccentricity(companionEngine, orbitAB.separation);
+			int ab = system.AddPair(a, b, orbitAB);
+
+			double massRatioAC = generateMassRatio(companionEngine);
+			int c = system.AddStar(Star(baseMass * massRatioAC));
+
+			double massRatioCD = generateHeavyMassRatio(companionEngine);
+			int d = system.AddStar(Star(baseMass * massRatioAC * massRatioCD));
+
+			OverallSeparation orbitCD;
+			orbitCD.separation = generateDistanceBetweenStars(companionEngine, baseMass * massRatioAC);
+			orbitCD.eccentricity = generateMultipleStarEccentricity(companionEngine, orbitCD.separation);
+			int cd = system.AddPair(c, d, orbitCD);
+
+			double maxAB = orbitAB.separation * (1 + orbitAB.eccentricity);
+			double maxCD = orbitCD.separation * (1 + orbitCD.eccentricity);
+
+			double maxSep;
+			if (maxAB > maxCD) { maxSep = maxAB; }
+			else { maxSep = maxCD; }
+
+			OverallSeparation orbitABCD;
+			orbitABCD.separation = generateDistanceBeyond(companionEngine, baseMass + baseMass * massRatioAC, 3 * maxSep);
+			orbitABCD.eccentricity = generateMultipleStarEccentricity(companionEngine, orbitABCD.separation);
+			system.AddPair(ab, cd, orbitABCD);
+		}
+	} // END IS_MULTIPLE
+	LOG(LOG_DEBUG) << "multiplicity: " << system.GetMultiplicity() << "\n";
+
+	// Age, Metallicity, Luminosity, Lifespan
+	double systemAge = generateSystemAge(ageEngine);
+	LOG(LOG_DEBUG) << "systemAge: " << systemAge << "\n";
+	//systemAge = 6.5; // for testing
+	double metallicity = generateMetallicity(ageEngine, systemAge);
+	LOG(LOG_DEBUG) << "metallicity: " << metallicity << "\n";
+
+	// evolve every star, each from its own stream
+	for (size_t i = 0; i < system.stars.size(); i++) {
+		RandomEngine evolutionEngine = makeStream(seed, i, -1, STAGE_EVOLUTION);
+		system.stars[i].SetAge(systemAge);
+		system.stars[i].SetMetallicity(metallicity);
+		evolveStar(system.stars[i], evolutionEngine);
+	}
+
+	return system;
+}
+
+/* findDisks
+ * Adds a PlanetarySystem for every disk within the node: two single stars
+ * closer than 1 AU share a circumbinary disk, and every other star has one
+ * of its own.  Disks are added in star order, so the primary's comes first.
+ */
+void findDisks (StarSystem & system, int node) {
+	int star = system.nodes[node].star;
+	int primary = system.nodes[node].primary;
+	int companion = system.nodes[node].companion;
+	OverallSeparation orbit = system.nodes[node].orbit;
+
+	PlanetarySystem disk;
+	disk.host = node;
+	if (star >= 0) { // S-type
+		setHostStar(system, disk);
+		disk.initialLuminosity = getInitialLuminosity(system.stars[star].GetMass());
+	}
+	else if (system.nodes[primary].star >= 0 && system.nodes[companion].star >= 0 && orbit.separation < 1.0) { // P-type
+		Star & starA = system.stars[system.nodes[primary].star];
+		Star & starB = system.stars[system.nodes[companion].star];
+		disk.circumbinary = true;
+		setHostStar(system, disk);
+		disk.initialLuminosity = getInitialLuminosity(starA.GetMass()) + getInitialLuminosity(starB.GetMass());
+		disk.innerExclusionZone = getOuterOrbitalExclusionZone(starA.GetMass(), starB.GetMass(), orbit.separation, orbit.eccentricity);
+	}
+	else {
+		findDisks(system, primary);
+		findDisks(system, companion);
+		return;
+	}
+
+	// the disk ends inside the smallest of the zones its host keeps clear of
+	// each pair it belongs to
+	disk.forbiddenZone = 1000000.0;
+	for (int inner = node, outer = system.nodes[node].parent; outer >= 0; inner = outer, outer = system.nodes[outer].parent) {
+		StellarNode & pair = system.nodes[outer];
+		int other = (pair.primary == inner) ? pair.companion : pair.primary;
+		double zone = getInnerOrbitalExclusionZone(system.GetNodeMass(inner), system.GetNodeMass(other), pair.orbit.separation, pair.orbit.eccentricity);
+		if (zone < disk.forbiddenZone) { disk.forbiddenZone = zone; }
+	}
+
+	system.planetSystems.push_back(move(disk));
+}
+
+/* setHostStar
+ * The star the disk's planets see: its host, or for a circumbinary disk the
+ * pair's masses and light together, at the stars' current age
+ */
+void setHostStar (StarSystem & system, PlanetarySystem & disk) {
+	StellarNode & host = system.nodes[disk.host];
+	if (!disk.circumbinary) {
+		disk.hostStar = system.stars[host.star];
+		return;
+	}
+
+	Star & starA = system.stars[system.nodes[host.primary].star];
+	Star & starB = system.stars[system.nodes[host.companion].star];
+	disk.hostStar.SetMass(starA.GetMass() + starB.GetMass());
+	disk.hostStar.SetLuminosity(starA.GetLuminosity() + starB.GetLuminosity());
+	disk.hostStar.SetRadius(starA.GetRadius());
+	disk.hostStar.SetTemperature(starA.GetTemperature());
+	disk.hostStar.SetAge(starA.GetAge());
+	disk.hostStar.SetMetallicity(starA.GetMetallicity());
+}
+
+/* getDiskComponent
+ * The star whose random streams the disk draws from: its host, or the
+ * primary of a circumbinary pair
+ */
+int getDiskComponent (StarSystem & system, PlanetarySystem & disk) {
+	StellarNode & host = system.nodes[disk.host];
+	return (host.star >= 0) ? host.star : system.nodes[host.primary].star;
+}
+
+/* rollEccentricityOffset
+ * How far the planet's eccentricity falls from the typical one for its
+ * disk, from the planet's own stream
+ */
+double rollEccentricityOffset (int seed, int component, int planet) {
+	RandomEngine e = makeStream(seed, component, planet, STAGE_ECCENTRICITY);
+	NormalDistribution randomNorm(-0.035, 0.02415); // 2d6-7 / 100
+	return randomNorm(e);
+}
+
+// whether formPlanetarySystems may use the formation workers; see setParallelFormation
+static atomic<bool> parallelFormation(true);
+
+/* setParallelFormation
+ * Batch runs that already keep every core busy with one system each turn
+ * this off, so that a multiple system does not hand disks to the formation
+ * workers (FormationPipeline.cpp) as well.
+ */
+void setParallelFormation (bool enabled) {
+	parallelFormation = enabled;
+}
+
+/* formPlanetarySystems
+ * Finds the disks of COUNT systems and runs PIPELINE over them.  If
+ * STAGESECONDS is not null, each stage's time is added to its entry.
+ * The disks draw from their own streams (keyed by the host's first star), so
+ * they do not depend on each other or on the order the stages take them in.
+ * Normally each stage runs over every disk of the batch before the next.
+ * A single system's disks may instead each go through the whole pipeline
+ * at once, all but the first on the formation workers, their LOG output
+ * written after the first disk's, in disk order; if the workers are busy
+ * with another caller's system, the disks go through together on this
+ * thread as for a batch.  While a decision trace is
+ * recording or -v is set, the disks go through the pipeline one after
+ * another on this thread, so that each disk's events and lines stay
+ * together and in order.
+ */
+void formPlanetarySystems (StarSystem * systems, size_t count, const Pipeline & pipeline, double * stageSeconds) {
+	size_t diskCount = 0;
+	for (size_t s = 0; s < count; s++) {
+		systems[s].planetSystems.reserve(systems[s].stars.size()); // at most one disk per star
+		findDisks(systems[s], systems[s].root);
+		diskCount += systems[s].planetSystems.size();
+	}
+
+	// the stages fill these in place; they are sized here, on this thread,
+	// since the arena they may come from is not safe to share between threads
+	pmr::vector<DiskJob> jobs(diskCount, systemMemory());
+	size_t j = 0;
+	for (size_t s = 0; s < count; s++) {
+		for (size_t d = 0; d < systems[s].planetSystems.size(); d++, j++) {
+			PlanetarySystem & disk = systems[s].planetSystems[d];
+			disk.planets.reserve(FormationSlots::capacity());
+			disk.formedClasses.reserve(FormationSlots::capacity());
+			jobs[j].disk = &disk;
+			jobs[j].seed = systems[s].seed;
+			jobs[j].component = getDiskComponent(systems[s], disk);
+		}
+	}
+
+	bool parallel = count == 1 && diskCount > 1 && parallelFormation && activeTrace == nullptr && stageSeconds == nullptr;
+	bool diagnostics = activeTrace != nullptr || getLogLevel() >= LOG_DEBUG;
+
+	if (parallel && runPipelineOnWorkers(pipeline, jobs.data(), diskCount)) {
+		logFinalLayout(systems[0]);
+		return;
+	}
+
+	if (!diagnostics) {
+		runPipeline(pipeline, jobs.data(), diskCount, stageSeconds);
+		return;
+	}
+
+	j = 0;
+	for (size_t s = 0; s < count; s++) {
+		for (size_t d = 0; d < systems[s].planetSystems.size(); d++, j++) {
+			runPipeline(pipeline, &jobs[j], 1, stageSeconds);
+		}
+		logFinalLayout(systems[s]);
+	}
+}
+
+/* logFinalLayout
+ * -v: every disk's planets as formation left them
+ */
+void logFinalLayout (StarSystem & system) {
+	LOG(LOG_DEBUG) << "Planets formed!\n";
+
+	for (size_t d = 0; d < system.planetSystems.size(); d++) {
+		PlanetarySystem & disk = system.planetSystems[d];
+		LOG(LOG_DEBUG) << "\nFinal layout around " << system.nodes[disk.host].name << "...:\n";
+		for (size_t i = 0; i < disk.planets.size(); i++) {
+			LOG(LOG_DEBUG) << i << ": " << disk.planets[i].GetDistance() << " AU; mass " << disk.planets[i].GetMass()
+				<< "; eccen " << disk.planets[i].GetEccentricity()
+				<< "; density " << disk.planets[i].GetDensity()
+				<< "; radius " << disk.planets[i].GetRadius()
+				<< "; gravity " << disk.planets[i].GetGravity()
+				<< "; class " << disk.planets[i].GetPlanetClass() << "\n";
+		}
+	}
+}
+
+/* EvolveSystem
+ * The system as it is, or was, at AGE (in Ga): the stars are evolved again
+ * from birth and each disk's planets get the periods, rotation, surface and
+ * life of that age.  The rest (the orbits, the planets' masses and sizes and
+ * their moons) is the result of formation and stays as it is, so a timeline
+ * of one seed always shows the same architecture, and each age costs a small
+ * part of generating the system.
+ */
+StarSystem EvolveSystem (StarSystem system, double age) {
+	for (size_t i = 0; i < system.stars.size(); i++) {
+		RandomEngine evolutionEngine = makeStream(system.seed, i, -1, STAGE_EVOLUTION);
+		system.stars[i].SetAge(age);
+		evolveStar(system.stars[i], evolutionEngine);
+	}
+
+	evolvePlanetarySystems(system, evolutionPipeline(), nullptr);
+	return system;
+}
+
+/* evolvePlanetarySystems
+ * Gives every disk the host its stars now make and runs PIPELINE (the
+ * stages of evolutionPipeline, or replacements for them) over its planets.
+ * Each planet starts again from its formed class, so a disk can be evolved
+ * to one age after another without forming it again.  If STAGESECONDS is
+ * not null, each stage's time is added to its entry.
+ */
+void evolvePlanetarySystems (StarSystem & system, const Pipeline & pipeline, double * stageSeconds) {
+	pmr::vector<DiskJob> jobs(system.planetSystems.size(), systemMemory());
+	for (size_t d = 0; d < jobs.size(); d++) {
+		PlanetarySystem & disk = system.planetSystems[d];
+		setHostStar(system, disk);
+		jobs[d].disk = &disk;
+		jobs[d].seed = system.seed;
+		jobs[d].component = getDiskComponent(system, disk);
+	}
+	runPipeline(pipeline, jobs.data(), jobs.size(), stageSeconds);
+}
+
+/* DescribeOptions
+ * Canonical "name=value;" text for an option set: equal options, equal text
+ */
+string DescribeOptions (GenerationOptions options) {
+	string description;
+	// the engine is fixed at compile time, but every seed depends on it
+	description += "rng=" RANDOM_ENGINE_NAME ";";
+	return description;
+}
+
+// ////////////////////////////////////
+// ////////////////////////////////////
+// ////////////////////////////////////
+// ////////////////////////////////////
+// ////////////////////////////////////
+// ////////////////////////////////////
+// ////////////////////////////////////
+// ////////////////////////////////////
+
+/*
+ * FUNCTION DEFINITIONS
+ */
+
+/* initialMassFunction
+ * This generates the *base* mass of the primary star
+ * This is based on Kroupa (2002)
+ * A random "basis" number is generated, based on the piecewise integral for the cumulative
+ * distribution function for mass.  This number is a real number between 0 and 4.7511, the
+ * area under the curve for masses between 0.01 and 2.18 solar masses (the latter being class
+ * A0 V).  This basis is used to determine which mass category the star falls into, i.e.
+ * which sub-equation to use.  A "second" real number is generated on a uniform distribution,
+ * and this produces the mass of the star.
+ */
+double initialMassFunction (RandomEngine & e) {
+	UniformRealDistribution randU(0, 1);
+	double basisU = randU(e);
+	double secondU = randU(e);
+
+	return kroupaMass(basisU, secondU);
+}
+
+/* kroupaMass
+ * The mass initialMassFunction gives for its two uniform draws
+ */
+double kroupaMass (double basisU, double secondU) {
+	double basis = basisU * 4.7511;
+	
+	if (basis <= 0.1869) {
+		double second = 2.1334 + secondU * (3.9811 - 2.1334);
+		return pow(second, 1 / -0.3);
+	}
+	else if (basis <= 3.1944) {
+		double second = 2.4623 + secondU * (26.6675 - 2.4623);
+		return pow(second, 1 / -1.3);
+	}
+	else if (basis <= 4.3192) {
+		double second = 1 + secondU * (4.9246 - 1);
+		return pow(second, 1 / -2.3);
+	}
+	else {
+		double second = 0.1219 + secondU * (1 - 0.1219);
+		return pow(second, 1 / -2.7);
+	}
+}
+
+
+/* isSystemMultiple
+ * Randomly determines if the system is multiple
+ * This is based on Duchene & Kraus (2013)
+ * TK
+ */
+bool isSystemMultiple (double mass, RandomEngine & e) {
+	UniformRealDistribution rUnif(0, 1);
+	double randomU = rUnif(e);
+
+	bool isMult = false;
+
+	if (mass <= 0.1) {
+		if (randomU <= 0.22) { isMult = true; };
+	}
+	else if (mass <= 0.5) {
+		if (randomU <= 0.26) { isMult = true; };
+	}
+	else if (mass <= 1.3) {
+		if (randomU <= 0.44) { isMult = true; };
+	}
+	else {
+		if (randomU <= 0.55) { isMult = true; };
+	}
+
+	return isMult;
+}
+
+
+/* generateSystemMultiplicity
+ * If the system generated is multiple, determine how many stars it consists of.
+ * Currently only binary, trinary, and quaternary systems are supported.
+ * This is based on TK
+ * TK
+ */
+int generateSystemMultiplicity(RandomEngine & e) {
+	UniformRealDistribution rUnif(0, 1);
+	double randomU = rUnif(e);
+
+	if (randomU <= 0.75) { return 2; }
+	else if (randomU <= 0.95) { return 3; }
+	else { return 4; }
+}
+
+double generateMassRatio(RandomEngine & e) {
+	UniformRealDistribution rUnif(0.05, 1);
+	double randomU = rUnif(e);
+
+	return randomU;
+}
+
+double generateHeavyMassRatio(RandomEngine & e) {
+	UniformRealDistribution rUnif(0.35, 1);
+	double randomU = rUnif(e);
+
+	return randomU;
+}
+
+bool flipCoin(RandomEngine & e) {
+	UniformIntDistribution coinFlipper(0, 1);
+
+	return coinFlipper(e);
+}
+
+// I can't make sense of the paper
+// The paper makes me think that 45 AU is the *mode*, in which case the mean is ln(45 - sigma^2) or 3.68.
+// Keeping the stdev of 2.3 seems to match the upper end of the distro (4.6% above 1500 AU), but not the lower end!
+double generateDistanceBetweenStars(RandomEngine & e, double primaryMass) {
+	if (primaryMass <= 0.1) {
+		LogNormalDistribution generator(1.45, 0.5);
+		return generator(e);
+	}
+	else if (primaryMass <= 0.5) {
+		LogNormalDistribution generator(1.28, 1.3);
+		return generator(e);
+	}
+	else {
+		LogNormalDistribution generator(3.68, 2.3);
+		return generator(e);
+	}
+}
+
+/* generateDistanceBeyond
+ * generateDistanceBetweenStars, given that the separation is at least
+ * MINIMUM; drawn straight from the truncated distribution with one draw,
+ * rather than redrawing until a separation clears it, which could take
+ * millions of tries for a low-mass primary
+ */
+double generateDistanceBeyond(RandomEngine & e, double primaryMass, double minimum) {
+	if (primaryMass <= 0.1) {
+		TruncatedLogNormalDistribution generator(1.45, 0.5, minimum);
+		return generator(e);
+	}
+	else if (primaryMass <= 0.5) {
+		TruncatedLogNormalDistribution generator(1.28, 1.3, minimum);
+		return generator(e);
+	}
+	else {
+		TruncatedLogNormalDistribution generator(3.68, 2.3, minimum);
+		return generator(e);
+	}
+}
+
+double generateMultipleStarEccentricity(RandomEngine & e, double separation) {
+	if (separation <= 0.2) { // ~20 days, M = 1.4 combined
+		return 0.0;
+	}
+	else {
+		return generateWideOrbitEccentricity(e);
+	}
+}
+
+/* generateWideOrbitEccentricity
+ * The eccentricity of an orbit wider than 0.2 AU
+ */
+double generateWideOrbitEccentricity(RandomEngine & e) {
+	NormalDistribution generator(0.4, 0.1);
+	double eccentricity = generator(e);
+	if (eccentricity < 0) { return 0.0; }
+	else if (eccentricity > 0.9) { return 0.9; }
+	else { return eccentricity; }
+}
+
+/* generateSystemAge
+ * Procedure taken from "Architect of Worlds 0.8"
+ */
+// d100 rolls up to 5: Extreme Population I, 31: Young Population I,
+// 82: Intermediate Population I, 97: Disk Population,
+// 99: Intermediate Population II, 100: Extreme Population II
+constexpr AliasTable<6> POPULATION_TABLE = makePercentileTable<6>({ 5, 31, 82, 97, 99, 100 });
+const double POPULATION_YOUNGEST[6] = { 0.0, 0.5, 3.0, 8.0, 9.5, 12.0 };
+const double POPULATION_AGE_SPREAD[6] = { 0.5, 2.5, 5.0, 1.5, 2.5, 1.5 };
+
+double generateSystemAge (RandomEngine & e) {
+	UniformRealDistribution randU(0, 1);
+
+	int population = POPULATION_TABLE(e);
+	return POPULATION_YOUNGEST[population] + randU(e) * POPULATION_AGE_SPREAD[population];
+}
+
+/* generateMetallicity
+ * Procedure taken from "Architect of Worlds 0.8"
+ */
+double generateMetallicity (RandomEngine & e, double age) {
+	int roll = rollThreeD6(e);
+	LOG(LOG_TRACE) << "metalroll: " << roll << "\n";
+	double temp = (roll / 10.0) * (1.2 - (age / 13.5));
+	if (temp < 0.05) { temp = 0.05; }
+	
+	return temp;
+}
+
+/* getInitialLuminosity
+ * Get the luminosity the star had at formation
+ * I derived this equation by doing two regressions on the table found in
+ * "Architect of Worlds 0.8," which is ultimately from Mamajek (2016) and
+ * Townsend (2016).
+ */
+double getInitialLuminosity (double mass) {
+	if (mass < 0.5) {
+		return 0.2106 * pow(mass, 2.3357);
+	}
+	else {
+		return 0.7329 * pow(mass, 4.6128);
+	}
+}
+
+/* getStellarLifespan
+ */
+double getStellarLifespan (double mass) {
+	if (mass < 0.43) {
+		return 43.0 * pow(mass, -1.3);
+	}
+	else if (mass < 2) {
+		return 10.0 * pow(mass, -3.0);
+	}
+	else {
+		return 7.1 * pow(mass, -2.5);
+	}
+}
+
+/* getInitialTemperature
+ * Get the temperature the star had at formation
+ * I derived this equation by doing multiple regressions on the table found in
+ * "Architect of Worlds 0.8," which is ultimately from Mamajek (2016) and
+ * Townsend (2016).  This equation is very ugly but it avoid a table at least!
+ */
+double getInitialTemperature (double mass) {
+	if (mass < 0.5) {
+		return 4335.95 + 684.72 * log (mass);
+	}
+	else if (mass < 1.3) {
+		double denominator = 1 + 4.2427 * exp(-2.914 * mass);
+		return 7007.56 / denominator;
+	}
+	else {
+		return 2857.576 * mass + 2537.984;
+	}
+}
+
+/* getStellarRadius
+ */
+double getStellarRadius (double lum, double temp) {
+	return pow(lum, 0.5) / pow(temp / 5772.0, 2.0);
+}
+
+/* evolveStar
+ * When invoked, age and mass need to have been calculated!
+ * The deterministic tracks are looked up in the evolution grid, which is
+ * built from the functions above.  The star is evolved from its initial
+ * mass, so it can be evolved again to another age.
+ */
+void evolveStar (Star & s, RandomEngine & e) {
+	ProfileTimer timer(PROFILE_EVOLVE_STAR);
+	const EvolutionGrid & grid = getEvolutionGrid();
+	double systemAge = s.GetAge();
+	double starMass = s.GetInitialMass();
+	s.SetMass(starMass);
+
+	if (starMass < 0.08) { // it's a brown dwarf
+		double temp = grid.GetBrownDwarfTemperature(starMass, systemAge);
+		s.SetTemperature(temp);
+
+		s.SetLuminosity(pow(temp, 4.0) / 1.1e17);
+
+		s.SetSpectralType(GetSpectralClass(s.GetTemperature()));
+		s.SetLuminosityClass(MAIN_SEQUENCE);
+
+		return;
+	}
+	
+	EvolutionGrid::Cell track = grid.LocateStar(starMass);
+	double lifespan = grid.GetLifespan(track);
+
+	if (systemAge <= lifespan) { // main sequence
+		double lum = grid.GetMainSequenceLuminosity(track, systemAge);
+		s.SetLuminosity(lum);
+
+		double temp = grid.GetInitialTemperature(track);
+		s.SetTemperature(temp);
+
+		double radius = getStellarRadius(lum, temp);
+		s.SetRadius(radius);
+
+		s.SetSpectralType(GetSpectralClass(temp));
+		s.SetLuminosityClass(MAIN_SEQUENCE);
+	}
+	else if (systemAge <= 1.15 * lifespan) {
+		UniformIntDistribution diceRoll(1, 100);
+		int roll = diceRoll(e);
+
+		if (roll <= 60) { // subgiant
+			UniformRealDistribution newLumRatio(2.0, 2.4);
+			
+			double initLum = grid.GetInitialLuminosity(track);
+			s.SetLuminosity(newLumRatio(e) * initLum);
+
+			double initTemp = grid.GetInitialTemperature(track);
+			UniformRealDistribution newTemp(5000, initTemp);
+			double newTemperature = newTemp(e);
+			s.SetTemperature(newTemperature);
+
+			double radius = getStellarRadius(newLumRatio(e) * initLum, newTemperature);
+			s.SetRadius(radius);
+
+			s.SetSpectralType(GetSpectralClass(newTemperature));
+			s.SetLuminosityClass(SUBGIANT);
+		}
+		else if (roll <= 90) { // red giant branch
+			UniformRealDistribution randomU(0, 1);
+			double randomNumber = randomU(e);
+
+			s.SetTemperature(5000 - randomNumber * 2000);
+			s.SetLuminosity(pow(50, 1 + randomNumber));
+			s.SetRadius(getStellarRadius(s.GetLuminosity(), s.GetTemperature()));
+
+			s.SetSpectralType(GetSpectralClass(s.GetTemperature()));
+			s.SetLuminosityClass(GIANT);
+		}
+		else { // Horizontal branch
+			UniformRealDistribution randomLum(50, 100);
+			s.SetLuminosity(randomLum(e));
+
+			NormalDistribution randomTemp(5000, 50);
+			s.SetTemperature(randomTemp(e));
+
+			s.SetRadius(getStellarRadius(s.GetLuminosity(), s.GetTemperature()));
+
+			s.SetSpectralType(GetSpectralClass(s.GetTemperature()));
+			s.SetLuminosityClass(BRIGHT_GIANT);
+		}
+	} // close 1.15 * lifespan
+	else { // white dwarf
+		double newMass = 0.43 + starMass / 10.4;
+		s.SetMass(newMass);
+
+		double postLifespan = systemAge - (1.15 * lifespan);
+		double temp = grid.GetWhiteDwarfTemperature(track, postLifespan);
+		s.SetTemperature(temp);
+
+		double radiusKM = 5500 / pow(newMass, 1 / 3);
+		double radius = radiusKM / 695700;
+		s.SetRadius(radius);
+
+		s.SetLuminosity(pow(radius, 2) * pow(temp / 5772, 4));
+
+		// Set Spectral Class
+		SpectralType whiteDwarf;
+		whiteDwarf.letter = SPECTRAL_D;
+		s.SetSpectralType(whiteDwarf);
+		s.SetLuminosityClass(WHITE_DWARF);
+	}
+
+	return;
+}
+
+/* generateDiskMassFactor
+ * Generates the size of the protoplanetary disk relative to the Sun's
+ * Implements algorithm on AOW pp. 37-38
+ */
+constexpr AliasTable<9> DISK_MASS_TABLE = makeThreeD6Table<9>({ 3, 5, 7, 9, 11, 13, 15, 17, 18 });
+const double DISK_MASS_FACTORS[9] = { 0.25, 0.36, 0.50, 0.70, 1.00, 1.40, 2.00, 2.80, 4.00 };
+
+double generateDiskMassFactor (RandomEngine & e) {
+	return DISK_MASS_FACTORS[DISK_MASS_TABLE(e)];
+}
+
+// 3d6, -3 for massive disks and +3 for light ones; 5 or less gives none,
+// 16 or more gives 1.0
+constexpr array<int, 12> MIGRATION_ROLLS = { 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+constexpr AliasTable<12> MIGRATION_TABLE_MASSIVE_DISK = makeThreeD6Table<12>(MIGRATION_ROLLS, -3);
+constexpr AliasTable<12> MIGRATION_TABLE = makeThreeD6Table<12>(MIGRATION_ROLLS);
+constexpr AliasTable<12> MIGRATION_TABLE_LIGHT_DISK = makeThreeD6Table<12>(MIGRATION_ROLLS, 3);
+const double MIGRATION_FACTORS[12] = { 0, 0.05, 0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9, 1.0 };
+
+double generateMigrationFactor (RandomEngine & e, double diskMassFactor) {
+	if (diskMassFactor >= 2.0) { return MIGRATION_FACTORS[MIGRATION_TABLE_MASSIVE_DISK(e)]; }
+	if (diskMassFactor < 1.0) { return MIGRATION_FACTORS[MIGRATION_TABLE_LIGHT_DISK(e)]; }
+	return MIGRATION_FACTORS[MIGRATION_TABLE(e)];
+}
+
+double getOuterSystemProperties(Planet & p, int mod, int pNumber, RandomEngine & e) {
+	int roll = rollThreeD6(e) + mod;
+	double pMass = p.GetMass();
+	TRACE_EVENT(TRACE_OUTER_SYSTEM_ROLL, pNumber, roll, mod, 0);
+
+	if (roll <= 14) {
+		p.SetPlanetClass(NONE);
+		p.SetMass(0);
+		if (pNumber == 5) {
+			return 0.25; // mass from middle zone sent to inner zone
+		}
+	}
+	else if (roll <= 18) {
+		p.SetPlanetClass(NONE);
+		p.SetMass(0);
+		if (pNumber == 5) {
+			return 0.20;
+		}
+	}
+	else if (roll <= 20) {
+		p.SetPlanetClass(FAILED_CORE);
+		UniformRealDistribution unifRoll(1, 6);
+		p.SetMass((unifRoll(e) + 3) * 0.25);
+		if (pNumber == 5) {
+			return 0.175;
+		}
+	}
+	else if (roll <= 22) {
+		p.SetPlanetClass(FAILED_CORE);
+		UniformRealDistribution unifRoll(1, 6);
+		p.SetMass((unifRoll(e) + 6) * 0.25);
+		if (pNumber == 5) {
+			return 0.15;
+		}
+	}
+	else if (roll <= 24) {
+		p.SetPlanetClass(FAILED_CORE);
+		UniformRealDistribution unifRoll(1, 6);
+		p.SetMass((unifRoll(e) + 9) * 0.25);
+		if (pNumber == 5) {
+			return 0.125;
+		}
+	}
+	else if (roll <= 26) {
+		p.SetPlanetClass(FAILED_CORE);
+		UniformRealDistribution unifRoll(1, 6);
+		p.SetMass((unifRoll(e) + 12) * 0.25);
+		if (pNumber == 5) {
+			return 0.125;
+		}
+	}
+	else if (roll <= 28) {
+		p.SetPlanetClass(SMALL_GAS_GIANT);
+		p.SetMass(1.1 * pMass);
+		if (pNumber == 5) {
+			return 0.1;
+		}
+	}
+	else if (roll <= 30) {
+		p.SetPlanetClass(SMALL_GAS_GIANT);
+		p.SetMass(1.6 * pMass);
+		if (pNumber == 5) {
+			return 0.1;
+		}
+	}
+	else if (roll <= 32) {
+		p.SetPlanetClass(SMALL_GAS_GIANT);
+		p.SetMass(2.4 * pMass);
+		if (pNumber == 5) {
+			return 0.075;
+		}
+	}
+	else if (roll <= 34) {
+		p.SetPlanetClass(SMALL_GAS_GIANT);
+		p.SetMass(3.6 * pMass);
+		if (pNumber == 5) {
+			return 0.075;
+		}
+	}
+	else if (roll <= 36) {
+		p.SetPlanetClass(MEDIUM_GAS_GIANT);
+		p.SetMass(5 * pMass);
+		if (pNumber == 5) {
+			return 0.05;
+		}
+	}
+	else if (roll <= 38) {
+		p.SetPlanetClass(MEDIUM_GAS_GIANT);
+		p.SetMass(6 * pMass);
+		if (pNumber == 5) {
+			return 0.05;
+		}
+	}
+	else if (roll <= 40) {
+		p.SetPlanetClass(MEDIUM_GAS_GIANT);
+		p.SetMass(7 * pMass);
+	}
+	else if (roll <= 42) {
+		p.SetPlanetClass(MEDIUM_GAS_GIANT);
+		p.SetMass(8.5 * pMass);
+	}
+	else if (roll <= 44) {
+		p.SetPlanetClass(LARGE_GAS_GIANT);
+		p.SetMass(10.0 * pMass);
+	}
+	else if (roll <= 46) {
+		p.SetPlanetClass(LARGE_GAS_GIANT);
+		p.SetMass(12.0 * pMass);
+	}
+	else if (roll <= 48) {
+		p.SetPlanetClass(LARGE_GAS_GIANT);
+		p.SetMass(14.0 * pMass);
+	}
+	else if (roll <= 50) {
+		p.SetPlanetClass(LARGE_GAS_GIANT);
+		p.SetMass(17.0 * pMass);
+	}
+	else {
+		p.SetPlanetClass(LARGE_GAS_GIANT);
+		p.SetMass(20.0 * pMass);
+	}
+
+	return 0.0;
+}
+
+/* getInnerOrbitalExclusionZone
+ * Maximum stable orbit around A only
+ */
+double getInnerOrbitalExclusionZone (double pMass, double sMass, double separation, double eccentricity) {
+	double combinedMass = pMass + sMass;
+	double bMassFraction = sMass / combinedMass;
+	double massRatio = pMass / sMass;
+
+	double r1Egg = separation * (0.49 * pow(massRatio, 2/3)) / (0.6 * pow(massRatio, 2/3) + log(1 + pow(massRatio, 1/3)));
+
+	return r1Egg * (0.733 * pow((1 - eccentricity), 1.2) * pow(bMassFraction, 0.07));
+}
+
+/* getOuterOrbitalExclusionZone
+ * Minimum stable orbit around both A and B
+ */
+double getOuterOrbitalExclusionZone (double pMass, double sMass, double separation, double eccentricity) {
+	double combinedMass = pMass + sMass;
+	double bMassFraction = sMass / combinedMass;
+
+	return 1.93 * separation * (1 + 1.01 * pow(eccentricity, 0.32)) * pow(bMassFraction * (1 - bMassFraction), 0.043);
+}
+
+// ////////////////////////////////////
+// ////////////////////////////////////
+// ////////////////////////////////////
+// ////////////////////////////////////
+// ////////////////////////////////////
+// ////////////////////////////////////
+// ////////////////////////////////////
+// ////////////////////////////////////
+
+/* setUpDisk
+ * The "disk" stage: the disk's mass and migration factors and the zones
+ * they give, and the twelve formation slots, each marked if it lies in an
+ * exclusion zone or just inside the slow accretion line
+ */
+DiskConditions setUpDisk (const PlanetarySystem & disk, int seed, int component, FormationSlots & sPlanets) {
+	ProfileTimer timer(PROFILE_DISK);
+	const Star & s = disk.hostStar;
+	double forbiddenZone = disk.forbiddenZone;
+	bool starIsCircumbinary = disk.circumbinary;
+	double initialLuminosity = disk.initialLuminosity;
+	double innerExclusionZone = disk.innerExclusionZone;
+	TRACE_EVENT(TRACE_DISK_HOST, -1, disk.circumbinary, component, disk.forbiddenZone);
+
+	RandomEngine diskEngine = makeStream(seed, component, -1, STAGE_DISK);
+
+	DiskConditions c;
+	c.diskMassFactor = generateDiskMassFactor(diskEngine);
+	c.migrationFactor = generateMigrationFactor(diskEngine, c.diskMassFactor);
+	TRACE_EVENT(TRACE_DISK_MASS_FACTOR, -1, 0, 0, c.diskMassFactor);
+	TRACE_EVENT(TRACE_MIGRATION_FACTOR, -1, 0, 0, c.migrationFactor);
+
+	c.diskInnerEdge = 0.005 * pow(s.GetMass(), 1.0 / 3.0);
+	c.slowAccretionLine = 20.0 * pow(s.GetMass(), 1.0 / 3.0);
+	double diskInnerEdge = c.diskInnerEdge;
+	double slowAccretionLine = c.slowAccretionLine;
+
+	c.innerFormationZone = 2.5 * s.GetMass() * s.GetMetallicity() * c.diskMassFactor;
+	c.middleFormationZone = 80.0 * s.GetMass() * s.GetMetallicity() * c.diskMassFactor;
+	c.outerFormationZone = 18.0 * s.GetMass() * s.GetMetallicity() * c.diskMassFactor;
+	double innerFormationZone = c.innerFormationZone;
+	double middleFormationZone = c.middleFormationZone;
+	double outerFormationZone = c.outerFormationZone;
+	LOG(LOG_TRACE) << "diskMassFactor: " << c.diskMassFactor << "\n";
+
+	sPlanets.clear();
+
+	// place inner planets
+	double planet0Distance = 0.6 * sqrt(initialLuminosity);
+	FormingPlanet & temp0 = sPlanets.emplace_back();
+	temp0.planet.SetDistance(planet0Distance);
+	temp0.planet.SetMass(0.08 * innerFormationZone);
+
+	double planet1Distance = 0.8 * sqrt(initialLuminosity);
+	FormingPlanet & temp1 = sPlanets.emplace_back();
+	temp1.planet.SetDistance(planet1Distance);
+	temp1.planet.SetMass(0.41 * innerFormationZone);
+
+	double planet2Distance = 1.2 * sqrt(initialLuminosity);
+	FormingPlanet & temp2 = sPlanets.emplace_back();
+	temp2.planet.SetDistance(planet2Distance);
+	temp2.planet.SetMass(0.39 * innerFormationZone);
+
+	double planet3Distance = 1.8 * sqrt(initialLuminosity);
+	FormingPlanet & temp3 = sPlanets.emplace_back();
+	temp3.planet.SetDistance(planet3Distance);
+	temp3.planet.SetMass(0.08 * innerFormationZone);
+	
+	double planet4Distance = 2.7 * sqrt(initialLuminosity);
+	FormingPlanet & temp4 = sPlanets.emplace_back();
+	temp4.planet.SetDistance(planet4Distance);
+	temp4.planet.SetMass(0.04 * innerFormationZone);
+
+	// place middle planets
+	double planet5Distance = 4.0 * sqrt(initialLuminosity);
+	FormingPlanet & temp5 = sPlanets.emplace_back();
+	temp5.planet.SetDistance(planet5Distance);
+	temp5.planet.SetMass(0.4 * middleFormationZone);
+
+	double planet6Distance = 6.0 * sqrt(initialLuminosity);
+	FormingPlanet & temp6 = sPlanets.emplace_back();
+	temp6.planet.SetDistance(planet6Distance);
+	temp6.planet.SetMass(0.25 * middleFormationZone);
+
+	double planet7Distance = 9.0 * sqrt(initialLuminosity);
+	FormingPlanet & temp7 = sPlanets.emplace_back();
+	temp7.planet.SetDistance(planet7Distance);
+	temp7.planet.SetMass(0.18 * middleFormationZone);
+
+	double planet8Distance = 13.5 * sqrt(initialLuminosity);
+	FormingPlanet & temp8 = sPlanets.emplace_back();
+	temp8.planet.SetDistance(planet8Distance);
+	temp8.planet.SetMass(0.17 * middleFormationZone);
+
+	// place outer planets
+	double planet9Distance = 20.0 * sqrt(initialLuminosity);
+	FormingPlanet & temp9 = sPlanets.emplace_back();
+	temp9.planet.SetDistance(planet9Distance);
+	temp9.planet.SetMass(0.6 * outerFormationZone);
+
+	double planet10Distance = 30.0 * sqrt(initialLuminosity);
+	FormingPlanet & temp10 = sPlanets.emplace_back();
+	temp10.planet.SetDistance(planet10Distance);
+	temp10.planet.SetMass(0.3 * outerFormationZone);
+
+	double planet11Distance = 45.0 * sqrt(initialLuminosity);
+	FormingPlanet & temp11 = sPlanets.emplace_back();
+	temp11.planet.SetDistance(planet11Distance);
+	temp11.planet.SetMass(0.1 * outerFormationZone);
+
+	// work exclusion zones
+	LOG(LOG_DEBUG) << "Working exclusion zones...\n";
+	for (int i = 0; i < sPlanets.size(); i++) {
+		double distance = sPlanets[i].planet.GetDistance();
+		if (distance < diskInnerEdge || distance > slowAccretionLine || distance > forbiddenZone || (distance < innerExclusionZone && starIsCircumbinary)) {
+			sPlanets[i].inExclusionZone = true;
+			TRACE_EVENT(TRACE_EXCLUSION_ZONE, i, 0, 0, distance);
+		}
+	}
+	// Mark last before slow accretiong
+	for (int i = 0; i < sPlanets.size(); i++) {
+		double distance = sPlanets[i].planet.GetDistance();
+		if (i + 1 < sPlanets.size()) {
+			if (distance < slowAccretionLine && sPlanets[i + 1].planet.GetDistance() > slowAccretionLine) {
+				sPlanets[i].lastBeforeSlowAccretion = true;
+				if (i > 0) { sPlanets[i - 1].penultBeforeSlowAccretion = true; }
+				break;
+			}
+		}
+		else {
+			sPlanets[i].lastBeforeSlowAccretion = true;
+			sPlanets[i - 1].penultBeforeSlowAccretion = true;
+		}
+	}
+
+	return c;
+}
+
+/* formOuterSystem
+ * The "outer system" stage: accretion in slots 5 to 11, which may turn
+ * them into gas giants
+ * Returns the share of the middle zone's mass that the first of them
+ * sends on into the inner system.
+ */
+double formOuterSystem (FormationSlots & sPlanets, int seed, int component) {
+	ProfileTimer timer(PROFILE_OUTER_SYSTEM);
+	// Outer Planetary System
+	LOG(LOG_DEBUG) << "Working outer system...\n";
+	double massToInnerSystem;
+	for (int i = 5; i < 12; i++) {
+		RandomEngine planetEngine = makeStream(seed, component, i, STAGE_OUTER_SYSTEM);
+		double planetesimalMass = sPlanets[i].planet.GetMass();
+
+		int accretionModifier = getAccretionModifier(planetesimalMass);
+
+		// modifier if close to slow accretion line
+		if (sPlanets[i].penultBeforeSlowAccretion) { accretionModifier -= 8; }
+		if (sPlanets[i].lastBeforeSlowAccretion) { accretionModifier -= 16; }
+
+		double temp = getOuterSystemProperties(sPlanets[i].planet, accretionModifier, i, planetEngine);
+		if (i == 5) {
+			massToInnerSystem = temp;
+		}
+	}
+	return massToInnerSystem;
+}
+
+/* migrateGiants
+ * The "migration" stage: the dominant gas giant, its migration inwards,
+ * the Grand Tack and the Nice event, and the outer planets placed around
+ * the giants
+ */
+GiantMigration migrateGiants (const PlanetarySystem & disk, const DiskConditions & conditions, FormationSlots & sPlanets, int seed, int component) {
+	ProfileTimer timer(PROFILE_MIGRATION);
+	double forbiddenZone = disk.forbiddenZone;
+	bool starIsCircumbinary = disk.circumbinary;
+	double innerExclusionZone = disk.innerExclusionZone;
+	double migrationFactor = conditions.migrationFactor;
+	double diskInnerEdge = conditions.diskInnerEdge;
+	double slowAccretionLine = conditions.slowAccretionLine;
+
+	RandomEngine dynamicsEngine = makeStream(seed, component, -1, STAGE_DYNAMICS);
+	RandomEngine outerPlacementEngine = makeStream(seed, component, -1, STAGE_OUTER_PLACEMENT);
+
+	// Find dominant gas giant
+	bool thereIsADominantGasGiant = false;
+	int gasGiantCount = 0;
+	int dominantGasGiantIndex = -1;
+	for (int i = 5; i < 12; i++) {
+		PlanetClass theClass = sPlanets[i].planet.GetPlanetClass();
+		if (theClass == SMALL_GAS_GIANT || theClass == MEDIUM_GAS_GIANT || theClass == LARGE_GAS_GIANT) {
+			sPlanets[i].isDominantGasGiant = true;
+			thereIsADominantGasGiant = true;
+			dominantGasGiantIndex = i;
+			break;
+		}
+	}
+	for (int i = 5; i < 12; i++) {
+		PlanetClass theClass = sPlanets[i].planet.GetPlanetClass();
+		if (theClass == SMALL_GAS_GIANT || theClass == MEDIUM_GAS_GIANT || theClass == LARGE_GAS_GIANT) {
+			gasGiantCount++;
+		}
+	}
+
+	// Dominant Gas Giant Inward Migration
+	bool thereWasInwardMigration = false;
+	double orbitAfterInwardMigration = 0;
+	double formationRadius = 0;
+	if (thereIsADominantGasGiant) {
+		for (int i = 5; i < 12; i++) {
+			if (sPlanets[i].isDominantGasGiant) {
+				formationRadius = sPlanets[i].planet.GetDistance();
+				orbitAfterInwardMigration = formationRadius * migrationFactor;
+				if (orbitAfterInwardMigration < diskInnerEdge && !starIsCircumbinary) { // gas giant migrates inwards
+					thereWasInwardMigration = true;
+					sPlanets[i].planet.SetDistance(orbitAfterInwardMigration);
+					TRACE_EVENT(TRACE_INWARD_MIGRATION, i, 0, 0, orbitAfterInwardMigration);
+				}
+				else if (orbitAfterInwardMigration < diskInnerEdge && starIsCircumbinary) {
+					thereWasInwardMigration = true;
+					if (orbitAfterInwardMigration < innerExclusionZone) {
+						sPlanets[i].planet.SetDistance(innerExclusionZone * 1.07);
+						orbitAfterInwardMigration = innerExclusionZone * 1.07;
+					}
+					else {
+						sPlanets[i].planet.SetDistance(orbitAfterInwardMigration);
+					}
+					TRACE_EVENT(TRACE_INWARD_MIGRATION, i, 0, 0, orbitAfterInwardMigration);
+				}
+				break;
+			}
+		}
+	}
+	if (thereWasInwardMigration) { // mark orbits as disturbed
+		for (int i = 0; i < sPlanets.size(); i++) {
+			if (sPlanets[i].planet.GetDistance() > orbitAfterInwardMigration && sPlanets[i].planet.GetDistance() < formationRadius) {
+				sPlanets[i].orbitDisrupted = true;
+			}
+		}
+	}
+
+	// Grand Tack
+	bool thereIsAGrandTack = false;
+	if (thereIsADominantGasGiant && gasGiantCount > 1) {
+		PlanetClass nextPlanet = sPlanets[dominantGasGiantIndex].planet.GetPlanetClass();
+		if (nextPlanet == SMALL_GAS_GIANT || nextPlanet == MEDIUM_GAS_GIANT || nextPlanet == LARGE_GAS_GIANT) { // Grand Tack is *possible*
+			int tackRoll = rollThreeD6(dynamicsEngine);
+			TRACE_EVENT(TRACE_GRAND_TACK_ROLL, dominantGasGiantIndex, tackRoll, tackRoll >= 12, 0);
+			if (tackRoll >= 12) {
+				int tackDistanceRoll = rollThreeD6(dynamicsEngine);
+				double finalDistance = (1 + tackDistanceRoll / 10.0) * sPlanets[dominantGasGiantIndex].planet.GetDistance();
+				TRACE_EVENT(TRACE_GRAND_TACK_DISTANCE, dominantGasGiantIndex, tackDistanceRoll, 0, finalDistance);
+				sPlanets[dominantGasGiantIndex].planet.SetDistance(finalDistance);
+				sPlanets[dominantGasGiantIndex].triggeredGrandTack = true;
+				thereIsAGrandTack = true;
+			}
+		}
+	}
+	if (thereIsAGrandTack) {
+		for (int i = dominantGasGiantIndex + 1; i < sPlanets.size(); i++) {
+			double priorFinalOrbitalRadius = sPlanets[i - 1].planet.GetDistance();
+			double currentOrbitalRadius = sPlanets[i].planet.GetDistance();
+			sPlanets[i].triggeredGrandTack = true;
+			if (priorFinalOrbitalRadius * 1.3 > currentOrbitalRadius) {
+				sPlanets[i].planet.SetDistance(priorFinalOrbitalRadius * 1.3);
+			}
+			else {
+				break;
+			}
+		}
+	}
+
+	// Nice Event
+	if (thereIsAGrandTack && (!forbiddenZone || forbiddenZone > 1.5 * slowAccretionLine)) { // depends on forbidden zones per AOW p. 47
+		// TBD: roll for Nice event!!!
+		bool aPlanetIsEjected = false;
+		for (int i = 5; i < 12; i++) {
+			if (sPlanets[i].triggeredGrandTack == false) {
+				int niceRoll = rollThreeD6(dynamicsEngine);
+				TRACE_EVENT(TRACE_NICE_ROLL, i, niceRoll, niceRoll >= 12, 0);
+				if (niceRoll >= 12) {
+					sPlanets[i].planetEjected = true;
+					aPlanetIsEjected = true;
+				}
+			}
+		}
+		// find last surviving planet and multiply orbit by 50%
+		if (aPlanetIsEjected) {
+			for (int i = 11; i > 5; i--) {
+				if (sPlanets[i].planetEjected && !sPlanets[i - 1].planetEjected) {
+					double oldRadius = sPlanets[i - 1].planet.GetDistance();
+					double newRadius = 1.5 * oldRadius;
+					sPlanets[i - 1].planet.SetDistance(newRadius);
+					break;
+				}
+			}
+		}
+	}
+
+	// Orbital resonances
+	// Dominant and outer-most gas giant should have final placement now
+	// (with no gas giant the index is -1, and writing there corrupts the heap)
+	if (dominantGasGiantIndex >= 0) { sPlanets[dominantGasGiantIndex].finalPlacement = true; }
+	int finalPlanetIndex = 12;
+	for (int i = 11; i > 5; i--) {
+		if (!sPlanets[i].planetEjected && sPlanets[i].planet.GetPlanetClass() != NONE) {
+			sPlanets[i].finalPlacement = true;
+			finalPlanetIndex = i;
+			break;
+		}
+	}
+	int countToBePlaced = 0;
+	for (int i = 6; i < 12; i++) {
+		if (!sPlanets[i].finalPlacement) { countToBePlaced++; }
+		else { break; }
+	}
+	placeRemainingPlanets (sPlanets, dominantGasGiantIndex, finalPlanetIndex, countToBePlaced, outerPlacementEngine);
+
+	GiantMigration migration;
+	migration.dominantGasGiantIndex = dominantGasGiantIndex;
+	migration.grandTack = thereIsAGrandTack;
+	return migration;
+}
+
+/* formInnerSystem
+ * The "inner system" stage: accretion in slots 0 to 4 from the inner zone
+ * and what the outer system sent in, migration towards the star, and the
+ * inner planets placed up to the dominant gas giant; then every slot that
+ * has ended up in an exclusion zone is marked
+ */
+void formInnerSystem (const PlanetarySystem & disk, const DiskConditions & conditions, double massToInnerSystem, const GiantMigration & migration, FormationSlots & sPlanets, int seed, int component) {
+	ProfileTimer timer(PROFILE_INNER_SYSTEM);
+	double forbiddenZone = disk.forbiddenZone;
+	bool starIsCircumbinary = disk.circumbinary;
+	double innerExclusionZone = disk.innerExclusionZone;
+	double migrationFactor = conditions.migrationFactor;
+	double diskInnerEdge = conditions.diskInnerEdge;
+	int dominantGasGiantIndex = migration.dominantGasGiantIndex;
+
+	RandomEngine migrationEngine = makeStream(seed, component, -1, STAGE_INNER_MIGRATION);
+	RandomEngine innerPlacementEngine = makeStream(seed, component, -1, STAGE_INNER_PLACEMENT);
+
+	double middleFormationZone = conditions.middleFormationZone * (1 - massToInnerSystem);
+	double innerFormationZone = conditions.innerFormationZone + (massToInnerSystem * middleFormationZone);
+
+	// INNER PLANETARY SYSTEM
+	LOG(LOG_DEBUG) << "Working inner system...\n";
+	innerFormationZone += 0;
+	for (int i = 0; i < 5; i++) {
+		RandomEngine e = makeStream(seed, component, i, STAGE_INNER_SYSTEM);
+		double planetesimalMass = innerFormationZone * sPlanets[i].planet.GetMass();
+		if (sPlanets[i].orbitDisrupted) { planetesimalMass *= 0.5; }
+
+		NormalDistribution randomNorm(1.05, 0.2958); // 3d6 / 10
+		double newMass = planetesimalMass * randomNorm(e);
+
+		if (newMass < 0.03) {
+			sPlanets[i].planet.SetPlanetClass(NONE);
+		}
+		else if (newMass < 0.18) {
+			if (i + 1 == dominantGasGiantIndex) {
+				sPlanets[i].planet.SetPlanetClass(LEFTOVER_OLIGARCH);
+				sPlanets[i].planet.SetMass(randomNorm(e) / 10.0);
+			}
+			else {
+				sPlanets[i].planet.SetPlanetClass(PLANETOID_BELT);
+			}
+		}
+		else {
+			sPlanets[i].planet.SetPlanetClass(TERRESTRIAL_PLANET);
+			sPlanets[i].planet.SetMass(newMass);
+		}
+	}
+
+	// Inner Planetary System Migration
+	int innermostPlanetIndex = 0;
+	for (int i = 0; i < 5; i++) {
+		double innermostMigrationRadius = sPlanets[i].planet.GetDistance() * migrationFactor;
+		if (innermostMigrationRadius < diskInnerEdge && !starIsCircumbinary) {
+			UniformIntDistribution diceRoll(1, 6);
+			int roll = diceRoll(migrationEngine);
+			TRACE_EVENT(TRACE_INNER_MIGRATION_ROLL, i, roll, roll <= 3, 0);
+			if (roll <= 3) { sPlanets[i].planetEjected = true; }
+			else {
+				sPlanets[i].planet.SetDistance(diskInnerEdge);
+				sPlanets[i].finalPlacement = true;
+				innermostPlanetIndex = i;
+				break;
+			}
+		}
+		else if (innermostMigrationRadius < diskInnerEdge && starIsCircumbinary) {
+			UniformIntDistribution diceRoll(1, 6);
+			int roll = diceRoll(migrationEngine);
+			TRACE_EVENT(TRACE_INNER_MIGRATION_ROLL, i, roll, roll <= 3, 0);
+			if (roll <= 3) { sPlanets[i].planetEjected = true; }
+			else {
+				if (innermostMigrationRadius > innerExclusionZone) {
+					sPlanets[i].planet.SetDistance(diskInnerEdge);
+					sPlanets[i].finalPlacement = true;
+					innermostPlanetIndex = i;
+					break;
+				}
+				else { // it'd be in the exclusion zone
+					sPlanets[i].planet.SetDistance(innerExclusionZone * 1.1);
+					sPlanets[i].finalPlacement = true;
+					innermostPlanetIndex = i;
+					break;
+				}
+			}
+		}
+	}
+	// If there are no remaining objects before the dominant gas giant, inner formation is done
+	// Else, if there are no gas giants, move the final planet outward
+
+	// Place remaining inner system
+	// count how many objects remain to be placed between innermost surviving object and either the dominant gas giant or, if no such, the outermost planet
+	int countToBePlaced = 0;
+	for (int i = innermostPlanetIndex + 1; i < dominantGasGiantIndex; i++) { // NOT QUITE RIGHT!
+		if (!sPlanets[i].finalPlacement) { countToBePlaced++; }
+		else { break; }
+	}
+	placeRemainingPlanets (sPlanets, innermostPlanetIndex, dominantGasGiantIndex, countToBePlaced, innerPlacementEngine);
+
+	// Make sure there aren't any in exclusion zones after migration!
+	for (int i = 0; i < sPlanets.size(); i++) {
+		double distance = sPlanets[i].planet.GetDistance();
+		if (distance < innerExclusionZone || distance > forbiddenZone) {
+			if (!sPlanets[i].inExclusionZone) { TRACE_EVENT(TRACE_EXCLUSION_ZONE, i, 0, 0, distance); }
+			sPlanets[i].inExclusionZone = true;
+		}
+	}
+}
+
+/* settlePlanets
+ * The "planets" stage: the slots that survived formation become the disk's
+ * planets, which get their eccentricities, densities, radii and surface
+ * gravities, and formation's classes are kept in formedClasses
+ */
+void settlePlanets (FormationSlots & sPlanets, const GiantMigration & migration, PlanetarySystem & disk, int seed, int component) {
+	ProfileTimer timer(PROFILE_PLANETS);
+	// Remove eliminated orbits
+	LOG(LOG_DEBUG) << "Removing eliminated orbits...\n";
+	// the survivors go straight into the disk, which formPlanetarySystems has made room in
+	pmr::vector<Planet> & sPlanets2 = disk.planets;
+	sPlanets2.clear();
+	for (int i = 0; i < sPlanets.size(); i++) {
+		const Planet & temp = sPlanets[i].planet;
+		LOG(LOG_TRACE) << "Doing planet " << i << "\n"
+			<< "Distance " << temp.GetDistance() << " AU; mass " << temp.GetMass()
+			<< "; ejected? " << sPlanets[i].planetEjected << "; exclusion? " << sPlanets[i].inExclusionZone
+			<< "; class? " << sPlanets[i].planet.GetPlanetClass() << "\n";
+		bool kept = !sPlanets[i].planetEjected && !sPlanets[i].inExclusionZone && sPlanets[i].planet.GetPlanetClass() != NONE;
+		TRACE_EVENT(TRACE_PLANET_RESULT, i, (sPlanets[i].planetEjected ? TRACE_FLAG_EJECTED : 0)
+			| (sPlanets[i].inExclusionZone ? TRACE_FLAG_EXCLUDED : 0)
+			| (sPlanets[i].orbitDisrupted ? TRACE_FLAG_DISRUPTED : 0)
+			| (sPlanets[i].triggeredGrandTack ? TRACE_FLAG_GRAND_TACK : 0)
+			| (kept ? TRACE_FLAG_KEPT : 0),
+			temp.GetPlanetClass(), temp.GetDistance());
+		if (kept) {
+			sPlanets2.push_back(move(sPlanets[i].planet));
+			LOG(LOG_TRACE) << "Planet " << i << " kept!\n";
+		}
+		else { LOG(LOG_TRACE) << "Planet " << i << " eliminated!\n"; }
+	}
+
+	LOG(LOG_TRACE) << "Printing sPlanets2...\n";
+	for (int i = 0; i < sPlanets2.size(); i++) {
+		LOG(LOG_TRACE) << i << ": " << sPlanets2[i].GetDistance() << "\n";
+	}
+
+	if (sPlanets2.size() == 0) {
+		LOG(LOG_DEBUG) << "All planets eliminated!\n\n";
+	}
+
+	// Set orbital eccentricities
+	LOG(LOG_DEBUG) << "Setting orbital eccentricities...\n";
+	int totalNumberOfPlanets = sPlanets2.size();
+	double typicalEccen = getTypicalEccentricity(totalNumberOfPlanets);
+	for (int i = 0; i < sPlanets2.size(); i++) {
+		double eccen = typicalEccen + rollEccentricityOffset(seed, component, i);
+		if (eccen < 0) { eccen = 0; }
+		sPlanets2[i].SetEccentricity(eccen);
+	}
+
+	// Density, Radius, and Surface Gravity
+	LOG(LOG_DEBUG) << "Determining densities, radii, and surface gravities...\n";
+	for (int i = 0; i < sPlanets2.size(); i++) {
+		RandomEngine e = makeStream(seed, component, i, STAGE_DENSITY);
+		PlanetClass pc = sPlanets2[i].GetPlanetClass();
+		double density;
+		if (pc == SMALL_GAS_GIANT || pc == MEDIUM_GAS_GIANT || pc == LARGE_GAS_GIANT) {
+			if (sPlanets2[i].GetMass() <= 200) {
+				density = 1.0 / sqrt(sPlanets2[i].GetMass());
+			}
+			else { // gas giant > 200 masses
+				density = pow(sPlanets2[i].GetMass(), 1.27) / 11800.0;
+			}
+		} // end gas giant
+		else if (pc != PLANETOID_BELT) {
+			NormalDistribution randomNorm(0.5, 2.958); // 3d6-10
+			density = pow(sPlanets2[i].GetMass(), 0.2) + randomNorm(e) / 100.0;
+			if (pc == FAILED_CORE) { density -= 0.1; }
+			if (pc == LEFTOVER_OLIGARCH) {
+				UniformIntDistribution diceRoll(1, 6);
+				int roll = diceRoll(e);
+				if (roll > 4) { density += 0.4; }
+			}
+			if (density < 0.18) { density = 0.18; }
+			if (density > 1.43) { density = 1.43; }
+		} // end not planetoid belt
+		else { // it's a planetoid belt
+			density = 0.0;
+		}
+		sPlanets2[i].SetDensity(density);
+
+		// compute radius and surface gravity
+		if (pc != PLANETOID_BELT) {
+			double radius = pow(sPlanets2[i].GetMass() / density, 1.0 / 3.0);
+			sPlanets2[i].SetRadius(radius);
+			sPlanets2[i].SetGravity(density * radius);
+		}
+		else {
+			sPlanets2[i].SetRadius(0.0);
+			sPlanets2[i].SetGravity(0.0);
+		}
+	}
+
+	disk.grandTack = migration.grandTack;
+	disk.formedClasses.clear();
+	for (int i = 0; i < sPlanets2.size(); i++) {
+		disk.formedClasses.push_back(sPlanets2[i].GetPlanetClass());
+	}
+}
+
+/* formMoons
+ * The "moons" stage: each planet's major moons, as many as its Hill sphere
+ * suggests, spaced outwards from the first
+ */
+void formMoons (PlanetarySystem & disk, const DiskConditions & conditions, int seed, int component) {
+	ProfileTimer timer(PROFILE_MOONS);
+	const Star & s = disk.hostStar;
+	double diskMassFactor = conditions.diskMassFactor;
+	pmr::vector<Planet> & sPlanets2 = disk.planets;
+
+	// place moons
+	LOG(LOG_DEBUG) << "Placing moons...\n";
+	for (int i = 0; i < sPlanets2.size(); i++) {
+		RandomEngine e = makeStream(seed, component, i, STAGE_MOONS);
+		double apastron = sPlanets2[i].GetDistance() * (1.0 - sPlanets2[i].GetEccentricity());
+		double hillSphereInKm = 2.17e6 * apastron * pow(sPlanets2[i].GetMass() / s.GetMass(), 1.0/3.0);
+		double moonEstimate = 2e-15 * pow(hillSphereInKm, 2.0) / sqrt(sPlanets2[i].GetDistance());
+		UniformIntDistribution plusMinus2(-2, 2);
+		int moonModifier = plusMinus2(e);
+		// clamp before converting: a NaN or huge estimate does not fit in an int
+		int numberOfMajorMoons = 0;
+		if (moonEstimate > 8) {
+			numberOfMajorMoons = 8;
+		}
+		else if (moonEstimate >= 1) {
+			numberOfMajorMoons = moonEstimate;
+		}
+		if (numberOfMajorMoons != 0) {
+			numberOfMajorMoons += moonModifier;
+		}
+		if (numberOfMajorMoons < 0) {
+			numberOfMajorMoons = 0;
+		}
+		LOG(LOG_TRACE) << "Planet " << i << " has " << numberOfMajorMoons << " major moons.\n";
+		sPlanets2[i].SetNumberOfMoons(numberOfMajorMoons);
+
+		int laplaceResonanceCount = 0;
+		double priorMoonDistance = 0;
+		for (int j = 0; j < numberOfMajorMoons; j++) {
+			NormalDistribution randomNorm(10.5, 2.958);
+			int roll = randomNorm(e);
+			double moonMass = 1e-5 * (roll * sPlanets2[i].GetMass()) / numberOfMajorMoons * diskMassFactor;
+			// TBD: a way to form even Mars-sized moons!  Perhaps this?
+			double distance = 0;
+			if (j == 0) { // it's the first moon
+				UniformRealDistribution rUnif(3, 8);
+				distance = rUnif(e) * sPlanets2[i].GetRadius() * 6371.0;
+				priorMoonDistance = distance;
+			}
+			else {
+				if (laplaceResonanceCount == 1) {
+					distance = priorMoonDistance * 1.587;
+					laplaceResonanceCount++;
+				}
+				else {
+					int spacing = MOON_SPACING_TABLE(e);
+					if (spacing == MOON_SPACING_RESONANCE) {
+						laplaceResonanceCount++;
+					}
+					else { laplaceResonanceCount = 0; }
+					distance = MOON_SPACING_RATIOS[spacing] * priorMoonDistance;
+				}
+				priorMoonDistance = distance;
+			}
+			//LOG(LOG_TRACE) << "distance: " << distance << "\n";
+			if (distance > hillSphereInKm) { break; }
+			sPlanets2[i].SetMoon(j, Moon(distance, moonMass));
+		}
+
+		// TBD: giant impact moons
+	}
+
+	LOG(LOG_TRACE) << "Final planets...\n";
+	LOG(LOG_TRACE) << "sPlanets2.size(): " << sPlanets2.size() << "\n";
+	for (int i = 0; i < sPlanets2.size(); i++) {
+		LOG(LOG_TRACE) << i << ": " << sPlanets2[i].GetDistance() << "\n";
+	}
+	LOG(LOG_TRACE) << "Returning...\n";
+}
+
+/* setOrbitalPeriods
+ * The "orbits" stage: each planet starts again from its formed class, and
+ * gets its orbital period about the host as it is now
+ */
+void setOrbitalPeriods (PlanetarySystem & disk) {
+	ProfileTimer timer(PROFILE_ORBITS);
+	const Star & s = disk.hostStar;
+	pmr::vector<Planet> & planets = disk.planets;
+
+	for (size_t i = 0; i < planets.size(); i++) {
+		planets[i].SetPlanetClass(disk.formedClasses[i]);
+	}
+
+	// orbital periods
+	LOG(LOG_DEBUG) << "Doing orbital periods...\n";
+	for (size_t i = 0; i < planets.size(); i++) {
+		double period = sqrt(pow(planets[i].GetDistance(), 3.0) / s.GetMass());
+		planets[i].SetOrbitalPeriod(period);
+	}
+}
+
+/* setRotation
+ * The "rotation" stage: rotation periods, tidal locking and axial tilt
+ */
+void setRotation (PlanetarySystem & disk, int seed, int component) {
+	ProfileTimer timer(PROFILE_ROTATION);
+	const Star & s = disk.hostStar;
+	pmr::vector<Planet> & planets = disk.planets;
+
+	// rotation periods and obliquity
+	LOG(LOG_DEBUG) << "Doing rotation periods...\n";
+	for (size_t i = 0; i < planets.size(); i++) {
+		RandomEngine e = makeStream(seed, component, i, STAGE_ROTATION);
+		double rotationPeriod;
+		double tideLockRadius = pow(s.GetAge() * pow(s.GetMass(), 2.0) / 479.0, 1.0 / 6.0);
+		bool isTidallyLocked = false;
+		if (planets[i].GetDistance() < tideLockRadius) { // tidally locked in some way
+			isTidallyLocked = true;
+			double year = planets[i].GetOrbitalPeriod();
+			double eccen = planets[i].GetEccentricity();
+			if (eccen <= 0.12) { rotationPeriod = year; }
+			else if (eccen <= 0.25) { rotationPeriod = year * 2.0 / 3.0; }
+			else if (eccen <= 0.35) { rotationPeriod = year / 2.0; }
+			else if (eccen <= 0.45) { rotationPeriod = year * 2.0 / 5.0; }
+			else { rotationPeriod = year / 3.0; }
+
+			rotationPeriod *= 8766; // in hours
+		}
+		else {
+			// temporary measure while I research this
+			// based on gut only: mean 24, stdev 1
+			// IQR is 12.22 to 47.11 hours (0.51 to 1.96 d)
+			LogNormalDistribution logNorm(3.18, 1.0);
+			rotationPeriod = logNorm(e);
+			if (rotationPeriod < 4.0) { rotationPeriod = 4.0; }
+		}
+
+		planets[i].SetRotationPeriod(rotationPeriod);
+
+		// axial tilt
+		double axis = 0;
+		if (planets[i].GetNumberOfMoons() > 0) { // has major moon(s), is terrestrial, leftover oligarch, failed core
+			NormalDistribution randomNorm(30.0, 9.0); // basically 4d6
+			axis = randomNorm(e);
+		}
+		else if (isTidallyLocked) {
+			NormalDistribution randomNorm(2.5, 3.0); // basically 3d6-8
+			axis = randomNorm(e);
+			if (axis < 0) { axis = 0; }
+		}
+		else { // not tidally locked, no moons, or gas giant
+			LogNormalDistribution randomLogNorm(3.56, 1.1); // average 35, IQR 16.7 - 73.5
+			axis = randomLogNorm(e);
+			if (axis < 0) { axis = 0; }
+		}
+		planets[i].SetAxialTilt(axis);
+	}
+	// solar day
+	// can do when printing
+}
+
+/* setSurfaces
+ * The "surface" stage: temperatures, and for terrestrial planets the
+ * oceans, atmosphere, class at this age, albedo and life
+ */
+void setSurfaces (PlanetarySystem & disk, int seed, int component) {
+	ProfileTimer timer(PROFILE_SURFACE);
+	const Star & s = disk.hostStar;
+	pmr::vector<Planet> & planets = disk.planets;
+	double formationIceLine = 4.0 * sqrt(disk.initialLuminosity);
+	bool thereIsAGrandTack = disk.grandTack;
+
+	// temperature and surface water
+	LOG(LOG_DEBUG) << "Doing surface properties...\n";
+	for (size_t i = 0; i < planets.size(); i++) {
+		RandomEngine e = makeStream(seed, component, i, STAGE_SURFACE);
+		PlanetClass pc = planets[i].GetPlanetClass();
+		// blackbody temp
+		double blackBodyTemp = 278.0 * pow(s.GetLuminosity(), 0.25) / sqrt(planets[i].GetDistance());
+		// minimum molecular weight retained
+		double squaredRadius = pow(planets[i].GetRadius() * 6371.0, 2.0);
+		double minMWR = 676300.0 * (blackBodyTemp / (planets[i].GetDensity() * squaredRadius));
+		minMWR = ceil(minMWR);
+
+		// ocean formation
+		bool thereWasARunawayGreenhouse = false;
+		if (pc == TERRESTRIAL_PLANET) { 
+			double oceanPctge;
+			if (minMWR <= 2) { oceanPctge = 1.0; }
+			else if (minMWR <= 28) {
+				if (planets[i].GetDistance() > formationIceLine) { oceanPctge = 1.0; }
+				else { // did not form beyond ice line
+					NormalDistribution randomNorm(0.55, 0.33); // basically 3d6
+					oceanPctge = randomNorm(e);
+					if (thereIsAGrandTack) {
+						oceanPctge += 0.2;
+					}
+					if (oceanPctge < 0.0) { oceanPctge = 0.0; }
+					if (oceanPctge > 1.0) { oceanPctge = 1.0; }
+				}
+			}
+			else { // MMWR >= 29
+				if (blackBodyTemp >= 125) {
+					// also if major gas giant moon closer than 8 radii
+					oceanPctge = 0.0;
+				}
+				else {
+					oceanPctge = 1.0;
+				}
+			} // close ocean else
+			// possible loss of primordial water
+			if (oceanPctge < 0.15 && blackBodyTemp >= 300) {
+				int roll = rollThreeD6(e);
+				if (blackBodyTemp + roll > 318) {
+					oceanPctge = 0.0;
+				}
+			}
+			if (oceanPctge > 0.15 && blackBodyTemp >= 300) {
+				int roll = rollThreeD6(e);
+				if (blackBodyTemp + roll > 318) { // runaway greenhouse
+					thereWasARunawayGreenhouse = true;
+					oceanPctge = 0.0;
+				}
+			}
+			planets[i].SetOceanPct(oceanPctge);
+			// end ocean formation
+
+			// Atmosphere
+			NormalDistribution threeD6Over100(0.106, 0.02958);
+
+			double molecularHydrogen = 0.0;
+			double helium = 0.0;
+			double nitrogen = 0.0;
+			double argon = 0.0;
+			double retentionFactor = 1.0;
+
+			// BS'd retention factor
+			// Don't really know what to base this on other than AOW's tables, so I'm using mass as a proxy
+			retentionFactor = pow(planets[i].GetMass(), 2.0);
+			if (retentionFactor > 3.0) { retentionFactor = 3.0; }
+			if (minMWR <= 2) {
+				molecularHydrogen = (0.9 + threeD6Over100(e)) * 100.0 * retentionFactor;
+			}
+			if (minMWR <= 4) {
+				double kFactor = 1.0;
+				if (minMWR <= 2) { kFactor = 25.0; }
+				else if (minMWR <= 3) { kFactor = 5.0; }
+				helium = (0.9 + threeD6Over100(e)) * kFactor * retentionFactor;
+			}
+			if (minMWR <= 28) {
+				nitrogen = (0.9 + threeD6Over100(e)) * 0.7 * retentionFactor;
+				if (blackBodyTemp <= 125 && oceanPctge == 1.0) {
+					nitrogen *= 15.0;
+				}
+			}
+			if (minMWR <= 40 && blackBodyTemp >= 90) {
+				argon = (0.9 + threeD6Over100(e)) * 0.01 * retentionFactor * s.GetMetallicity();
+			}
+
+			// Reassign world classes
+			// I'm assuming "significant" atmosphere is between Mars and Venus, or mass 0.07 (geomean), which is retentionFactor 0.005
+			PlanetClass newPlanetClass = pc;
+			if (thereWasARunawayGreenhouse) {
+				newPlanetClass = VENUSIAN;
+			}
+			else if (molecularHydrogen > 0 && retentionFactor > 0.005) {
+				newPlanetClass = HYCEAN;
+			}
+			else if (molecularHydrogen == 0 && nitrogen > 0 && blackBodyTemp >= 80 && blackBodyTemp <= 125 && retentionFactor > 0.005) {
+				newPlanetClass = TITANIAN;
+			}
+			else if (molecularHydrogen == 0 && nitrogen > 0 && blackBodyTemp > 125 && retentionFactor > 0.005) {
+				newPlanetClass = GAIAN;
+			}
+			else if (molecularHydrogen == 0 && nitrogen == 0 && helium == 0 && blackBodyTemp > 195 && retentionFactor > 0.005) {
+				newPlanetClass = MARTIAN;
+			}
+			planets[i].SetPlanetClass(newPlanetClass);
+
+			// albedo
+			double albedo;
+			albedo = threeD6Over100(e);
+
+			if (newPlanetClass == VENUSIAN) {
+				albedo += 0.65;
+			}
+			if (newPlanetClass == HYCEAN) {
+				albedo += 0.20;
+			}
+			if (newPlanetClass == TITANIAN) {
+				albedo += 0.10;
+			}
+			if (newPlanetClass == GAIAN || newPlanetClass == MARTIAN) {
+				double oceans = planets[i].GetOceanPct();
+				if (oceans == 0) { albedo += 0.15; }
+				else if (oceans < 0.15) { albedo += 0.16; }
+				else if (oceans < 0.65) { albedo += 0.19; }
+				else if (oceans < 1.0) { albedo += 0.22; }
+				else { albedo += 0.25; }
+			}
+			if (newPlanetClass == TERRESTRIAL_PLANET) {
+				double oceans = planets[i].GetOceanPct();
+				if (oceans == 0) { albedo += 0.01; }
+				else if (oceans < 0.15) { albedo += 0.02; }
+				else if (oceans < 0.65) { albedo += 0.08; }
+				else if (oceans < 1.0) { albedo += 0.14; }
+				else { albedo += 0.20; }
+				// if temp < 80K add 0.3
+			}
+			planets[i].SetAlbedo(albedo);
+
+			// First CO2 estimate
+			double firstCO2Estimate = (0.90 + threeD6Over100(e)) * 10.0 * retentionFactor;
+			if (newPlanetClass == VENUSIAN) {
+				firstCO2Estimate = (0.90 + threeD6Over100(e)) * 100.0 * retentionFactor;
+			}
+
+			bool isACarbonSilicateCycle = false;
+			int tValue = (blackBodyTemp * pow(1 - albedo, 0.25)) + (9.97 * log10(firstCO2Estimate)) + 31.8;
+			if (tValue >= 260) { isACarbonSilicateCycle = true; }
+
+			// life
+			// I feel guilty for slavishly following AOW, so I'm only gonna do partial here
+			// TBD: a better algorithm!
+			bool thereIsLife = false;
+			bool thereWasAnOxygenCatastrophe = false;
+			double atmosphericOxygen = 0.0;
+			double atmosphericWaterVapor = 0.0;
+			if (newPlanetClass != VENUSIAN && (isACarbonSilicateCycle || oceanPctge > 0.0)) {
+				if (s.GetAge() > 1.0) { thereIsLife = true; }
+				if (s.GetAge() > 2.0) { thereWasAnOxygenCatastrophe = true; }
+			}
+			if (thereIsLife) {
+				atmosphericOxygen = threeD6Over100(e) * 0.2;
+			}
+			if (thereWasAnOxygenCatastrophe) {
+				NormalDistribution oxygenGen(0.256, 0.02958);
+				atmosphericOxygen = oxygenGen(e) * retentionFactor;
+			}
+
+			// surface temperature
+			double averageSurfaceTemperature;
+			if (newPlanetClass == VENUSIAN) {
+				averageSurfaceTemperature = blackBodyTemp * pow(1.0 - albedo, 0.25) + (250.0 * log10(firstCO2Estimate));
+			}
+			else if (newPlanetClass == TERRESTRIAL_PLANET || retentionFactor == 0) {
+				averageSurfaceTemperature = blackBodyTemp * pow(1.0 - albedo, 0.25);
+			}
+			else { // Gaian, etc surface temp
+				averageSurfaceTemperature = blackBodyTemp * pow(1.0 - albedo, 0.25);
+
+				double methaneGreenhouse = 0.0;
+				double ozoneGreenhouse = 0.0;
+				double carbonDioxideGreenhouse = 0.0;
+				double waterGreenhouse = 0.0;
+
+				if (newPlanetClass == HYCEAN || newPlanetClass == TITANIAN || (newPlanetClass == GAIAN && thereIsLife)) {
+					methaneGreenhouse = 2.1 + (9.97 * log10(retentionFactor));
+				}
+				if (thereWasAnOxygenCatastrophe) {
+					ozoneGreenhouse = 1.7 + (9.97 * log10(retentionFactor));
+				}
+				averageSurfaceTemperature += methaneGreenhouse;
+				averageSurfaceTemperature += ozoneGreenhouse;
+
+				// CO2 greenhouse and adjustment
+				if (isACarbonSilicateCycle) {
+					double minC = 260 - averageSurfaceTemperature;
+					if (minC > 8.0) { carbonDioxideGreenhouse = minC; }
+					else { carbonDioxideGreenhouse = 8.0; }
+
+					// revise CO2 mass fraction
+					firstCO2Estimate = 6.46e-4 * pow(10.0, carbonDioxideGreenhouse / 9.97);
+				}
+				else {
+					carbonDioxideGreenhouse = 31.8 + (9.97 * log10(firstCO2Estimate));
+				}
+
+				averageSurfaceTemperature += carbonDioxideGreenhouse;
+
+				// Water vapor greenhouse
+				if (minMWR <= 18 && blackBodyTemp > 260 && oceanPctge > 0.15) {
+					waterGreenhouse = getWaterGreenhouse(averageSurfaceTemperature, oceanPctge);
+
+					atmosphericWaterVapor = 2.93e-5 * pow(10.0, waterGreenhouse / 9.97);
+				}
+				averageSurfaceTemperature += waterGreenhouse;
+			} // END Gaian, etc surface temp
+			// set surface temperature here
+			planets[i].SetTemperature(averageSurfaceTemperature);
+
+			// finalize atmosphere
+			double atmosphericMass = molecularHydrogen + helium + nitrogen + argon + firstCO2Estimate + atmosphericOxygen + atmosphericWaterVapor;
+
+			//double componentK = (1.0 / atmosphericMass) * ((2.0 * molecularHydrogen) + (4.0 * helium) + (18.0 * atmosphericWaterVapor) + (28.0 * nitrogen) + (32.0 * atmosphericOxygen) + (40.0 * argon) + (44.0 * firstCO2Estimate));
+			//double scaleHeight = 0.856 * (averageSurfaceTemperature / (componentK * planets[i].GetGravity()));
+
+			double atmosphericPressure = atmosphericMass * planets[i].GetGravity();
+
+			Atmosphere atmos;
+			atmos.hydrogen = molecularHydrogen / atmosphericMass;
+			atmos.helium = helium / atmosphericMass;
+			atmos.nitrogen = nitrogen / atmosphericMass;
+			atmos.argon = argon / atmosphericMass;
+			atmos.carbonDioxide = firstCO2Estimate / atmosphericMass;
+			atmos.waterVapor = atmosphericWaterVapor / atmosphericMass;
+			atmos.oxygen = atmosphericOxygen / atmosphericMass;
+			atmos.pressure = atmosphericPressure;
+			planets[i].SetAtmosphere(atmos);
+
+
+		} // end if (pc == TERRESTRIAL_PLANET || pc == LEFTOVER_OLIGARCH)
+		else {
+			planets[i].SetTemperature(blackBodyTemp);
+		}
+	}
+}
+
+void placeRemainingPlanets (FormationSlots & pVector, int firstPlanetIndex, int lastPlanetIndex, int countToBePlaced, RandomEngine & e) {
+	// without a dominant gas giant (index -1) there is nothing to space the others against
+	if (firstPlanetIndex < 0 || lastPlanetIndex < 0) { return; }
+
+	// an index past the last slot means there is no outer planet to space towards;
+	// the expected ratio is then 0 and every planet falls back to the 4:3 minimum
+	double lastPlanetDistance = 0.0;
+	if (lastPlanetIndex < (int) pVector.size()) { lastPlanetDistance = pVector[lastPlanetIndex].planet.GetDistance(); }
+	double expectedRatio = pow(lastPlanetDistance / pVector[firstPlanetIndex].planet.GetDistance(), 1.0 / (countToBePlaced + 1));
+
+	NormalDistribution randomOrbitalRatio(1.025, 0.22); // TBD AOW p. 48
+	for (int i = firstPlanetIndex + 1; i < lastPlanetIndex; i++) {
+		// place planet
+		double baseOrbitRatio = randomOrbitalRatio(e);
+		double finalOrbitRatio = expectedRatio * baseOrbitRatio;
+		if (finalOrbitRatio < 1.211) { finalOrbitRatio = 1.211; } // 4:3 resonance
+		double lastDistance = pVector[i - 1].planet.GetDistance();
+		pVector[i].planet.SetDistance(finalOrbitRatio * lastDistance);
+		pVector[i].finalPlacement = true;
+		// TBD: orbital resonance
+	}
+	return;
+}
+
+/* getWaterGreenhouse
+ * This is my own regression on AOW's tables on p. 102.
+ * Moderate: -430.418 + 80.4529 * ln(temp); r^2 = 0.99352
+ * Excessive: -427.418 + 80.4529 * ln(temp)
+ * Massive: -426.418 + 80.452917 * ln(temp)
+ */
+double getWaterGreenhouse (double temp, double ocean) {
+	double returnThis;
+	if (ocean < 0.65) {
+		returnThis = -430.418 + 80.4529 * log(temp);
+		if (temp > 334) { returnThis = 37.0; }
+	}
+	else if (ocean < 1) {
+		returnThis = -427.418 + 80.4529 * log(temp);
+		if (temp > 334) { returnThis = 40.0; }
+	}
+	else {
+		returnThis = -426.418 + 80.4529 * log(temp);
+		if (temp > 334) { returnThis = 41.0; }
+	}
+
+	return returnThis;
+}
@@ -0,0 +1,64 @@
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include <random>
+#include <vector>
+#include <string>
+#include "Star.h"
+#include "Planet.h"
+#include "StarSystem.h"
+#include "RandomEngine.h"
+#include "FormationPipeline.h"
+using namespace std;
+
+// constants
+const string VERSION_NUMBER = "0.19";
+
+/* GenerationOptions
+ * Settings that change what GenerateSystem produces for a seed
+ * A default-constructed set of options gives the same systems as the
+ * command line does without any flags.  Every field must also be written
+ * out by DescribeOptions, which the output cache uses to tell option sets apart.
+ */
+struct GenerationOptions {
+};
+
+StarSystem GenerateSystem (int seed, GenerationOptions options);
+pmr::vector<StarSystem> GenerateSystems (const int * seeds, size_t count, GenerationOptions options);
+StarSystem GenerateStars (int seed, GenerationOptions options);
+StarSystem EvolveSystem (StarSystem system, double age);
+void setParallelFormation (bool enabled);
+string DescribeOptions (GenerationOptions options);
+
+// Function declarations
+double initialMassFunction (RandomEngine & e);
+double kroupaMass (double basisU, double secondU);
+bool isSystemMultiple (double mass, RandomEngine & e);
+int generateSystemMultiplicity(RandomEngine & e);
+double generateHeavyMassRatio(RandomEngine & e);
+double generateMassRatio(RandomEngine & e);
+bool flipCoin(RandomEngine & e);
+double generateDistanceBetweenStars(RandomEngine & e, double primaryMass);
+double generateDistanceBeyond(RandomEngine & e, double primaryMass, double minimum);
+double generateMultipleStarEccentricity(RandomEngine & e, double separation);
+double generateWideOrbitEccentricity(RandomEngine & e);
+double generateSystemAge (RandomEngine & e);
+double generateMetallicity (RandomEngine & e, double age);
+double getInitialLuminosity (double mass);
+double getStellarLifespan (double mass);
+double getInitialTemperature (double mass);
+double getStellarRadius (double lum, double temp);
+void evolveStar (Star & s, RandomEngine & e);
+double generateDiskMassFactor (RandomEngine & e);
+double generateMigrationFactor (RandomEngine & e, double diskMassFactor);
+double getOuterSystemProperties(Planet & p, int mod, int pNumber, RandomEngine & e);
+double getInnerOrbitalExclusionZone (double pMass, double sMass, double separation, double eccentricity);
+double getOuterOrbitalExclusionZone (double pMass, double sMass, double separation, double eccentricity);
+int getDiskComponent (StarSystem & system, PlanetarySystem & disk);
+double getTypicalEccentricity (int planets);
+double rollEccentricityOffset (int seed, int component, int planet);
+void formPlanetarySystems (StarSystem * systems, size_t count, const Pipeline & pipeline, double * stageSeconds);
+void evolvePlanetarySystems (StarSystem & system, const Pipeline & pipeline, double * stageSeconds);
+double getWaterGreenhouse (double temp, double ocean);
+
+#endif // GENERATOR_H
@@ -0,0 +1,329 @@
+#include <iostream>
+#include <array>
+#include <string>
+#include <iomanip>          // setprecision
+#include <cmath>
+#include "Star.h"
+#include "Planet.h"
+#include "Moon.h"
+#include "StarSystem.h"
+#include "HtmlWriter.h"
+#include "Profiler.h"
+using namespace std;
+
+// Function declarations
+void writeStarRowsHtml (ostream & outFile, const Star & star);
+void writePlanetsHtml (ostream & outFile, const pmr::string & hostName, PlanetarySystem & disk);
+
+/* WriteSystemHtml
+ * Writes the HTML page for a generated system
+ */
+void WriteSystemHtml (ostream & outFile, StarSystem & system) {
+	ProfileTimer timer(PROFILE_HTML);
+	outFile << "<html>\n\t<head>\n\t\t<title>GenSystem #" << system.seed << "</title>\n";
+	outFile << "\t\t<link href=\"../misc/styles.css\" rel=\"stylesheet\" type=\"text/css\" media=\"all\" />\n\t</head>";
+	outFile << "\n\t<body>\n";
+	outFile << "\t\t<h1>System " << system.seed << "</h1>\n\n";
+
+	pmr::string systemName("System ", systemMemory());
+	systemName += to_string(system.seed);
+	if (system.GetMultiplicity() == 1) {
+		Star & star = system.stars[0];
+		outFile << "\t\t<table class=\"infobox\">\n";
+		outFile << "\t\t\t<colgroup><col width=\"300\" /><col width=\"300\" /></colgroup>\n";
+		outFile << "\t\t\t<tr><th class=\"star\" colspan=\"2\">" << systemName << "</th></tr>\n\n";
+		writeStarRowsHtml(outFile, star);
+		outFile << "\t\t\t<tr><td><strong>Age</strong></td><td>";
+		outFile << star.GetAge() << " Ga</td></tr>\n";
+		outFile << "\t\t</table>\n";
+	}
+	else { // is multiple
+		outFile << "\t\t<table class=\"infobox\">\n";
+		outFile << "\t\t\t<colgroup><col width=\"300\" /><col width=\"300\" /></colgroup>\n";
+		outFile << "\t\t\t<tr><th class=\"star\" colspan=\"2\">" << systemName << "</th></tr>\n";
+		outFile << "\t\t\t<tr><td><strong>Age</strong></td><td>";
+		outFile << system.stars[0].GetAge() << " Ga</td></tr>\n";
+		outFile << "\t\t\t<tr><td><strong>Hierarchy</strong></td><td>";
+		outFile << system.DescribeHierarchy(system.root) << "</td></tr>\n";
+
+		for (int i = 0; i < system.GetMultiplicity(); i++) {
+			outFile << "\t\t\t<tr><th class=\"star\" colspan=\"2\">" << systemName << " " << (char) ('A' + i) << "</th></tr>\n";
+			writeStarRowsHtml(outFile, system.stars[i]);
+		}
+
+		// print orbits, innermost first
+		pmr::vector<int> pairs(systemMemory());
+		system.GetOrbitsInnermostFirst(system.root, pairs);
+		for (size_t i = 0; i < pairs.size(); i++) {
+			StellarNode & pair = system.nodes[pairs[i]];
+			outFile << "\t\t\t<tr><th class=\"star\" colspan=\"2\">Orbit</th></tr>\n";
+			outFile << "\t\t\t<tr>\n\t\t\t\t<td><strong>Primary</strong></td>\n";
+			outFile << "\t\t\t\t<td>" << system.nodes[pair.primary].name << "</td>\n\t\t\t</tr>\n";
+			outFile << "\t\t\t<tr>\n\t\t\t\t<td><strong>Companion</strong></td>\n";
+			outFile << "\t\t\t\t<td>" << system.nodes[pair.companion].name << "</td>\n\t\t\t</tr>\n";
+			outFile << "\t\t\t<tr>\n\t\t\t\t<td><strong>Period</strong></td>\n";
+
+			double separation = pair.orbit.separation;
+			double eccentricity = pair.orbit.eccentricity;
+			double period = sqrt(pow(separation, 3.0) / system.GetNodeMass(pairs[i]));
+
+			outFile << "\t\t\t\t<td>" << period << " a</td>\n\t\t\t</tr>\n";
+			outFile << "\t\t\t<tr>\n\t\t\t\t<td><strong>Semi-major axis</strong></td>\n";
+			outFile << "\t\t\t\t<td>" << separation << " AU</td>\n\t\t\t</tr>\n";
+			outFile << "\t\t\t<tr>\n\t\t\t\t<td><strong>Eccentricity</strong></td>\n";
+			outFile << "\t\t\t\t<td>" << eccentricity << "</td>\n\t\t\t</tr>\n";
+		}
+
+		outFile << "\t\t</table>\n";
+	} // close is multiple
+
+	// one section per disk; in a multiple system each is named for its host
+	for (size_t d = 0; d < system.planetSystems.size(); d++) {
+		PlanetarySystem & disk = system.planetSystems[d];
+		pmr::string hostName(systemName, systemMemory());
+		if (system.GetMultiplicity() > 1) {
+			hostName += ' ';
+			hostName += system.nodes[disk.host].name;
+		}
+		writePlanetsHtml(outFile, hostName, disk);
+	}
+
+	outFile << "\t\t<p>Generated by <a href=\"https://github.com/giancarlow333/GenSystem\">GenSystem</a>!</p>";
+	outFile << "\t</body>\n</html>";
+}
+
+/* writeStarRowsHtml
+ * Spectral type, mass, radius, luminosity and temperature rows of an infobox
+ */
+void writeStarRowsHtml (ostream & outFile, const Star & star) {
+	outFile << "\t\t\t<tr><td><strong>Spectral type</strong></td><td>";
+	outFile << star.GetSpectralType() << " " << star.GetLuminosityClass() << "</td></tr>\n";
+	outFile << "\t\t\t<tr><td><strong>Mass</strong></td><td>";
+	outFile << star.GetMass() << " M<sub>&#x2609;</sub></td></tr>\n";
+	outFile << "\t\t\t<tr><td><strong>Radius</strong></td><td>";
+	outFile << star.GetRadius() << " R<sub>&#x2609;</sub></td></tr>\n";
+	outFile << "\t\t\t<tr><td><strong>Luminosity</strong></td><td>";
+	outFile << star.GetLuminosity() << " L<sub>&#x2609;</sub></td></tr>\n";
+	outFile << "\t\t\t<tr><td><strong>Temperature</strong></td><td>";
+	outFile << star.GetTemperature() << " K</td></tr>\n";
+}
+
+/* writePlanetsHtml
+ * The summary table and the full details of one disk's planets
+ */
+void writePlanetsHtml (ostream & outFile, const pmr::string & hostName, PlanetarySystem & disk) {
+	pmr::vector<Planet> & planets = disk.planets;
+	outFile << "\t\t<h2>" << hostName << " planets</h2>\n\n";
+
+	/*
+   * SUMMARY TABLE
+   */
+	outFile << "\t\t<table class=\"infobox\">\n";
+	outFile << "\t\t\t<colgroup><col width=\"50\" /><col width=\"50\" /><col width=\"300\" /><col width=\"300\" /><col width=\"300\" /><col width=\"300\" /></colgroup>\n";
+	outFile << "\t\t\t<tr><th colspan=\"6\">" << hostName << "</th></tr>\n";
+	outFile << "\t\t\t<tr><th>&numero;</th><th colspan=\"2\">Type</th><th>Distance</th><th>Mass</th><th>Radius</th></tr>\n";
+	for (size_t i = 0; i < planets.size(); i++) {
+		char planetNo = i + 98;
+		outFile << "\t\t\t<tr>\n\t\t\t\t<td><a href=\"#" << hostName << " " << planetNo << "\">" << planetNo << "</a></td>\n";
+		PlanetClass theClass = planets[i].GetPlanetClass();
+		const char * className;
+		const char * imgFileName;
+
+		printPlanetaryClass (theClass, className, imgFileName);
+		
+		outFile << "\t\t\t\t<td><img src=\"../misc/" << imgFileName << "\" width=\"20\" /></td>\n";
+		outFile << "\t\t\t\t<td>" << className << "</td>\n";
+		outFile << "\t\t\t\t<td>" << planets[i].GetDistance() << " AU</td>\n";
+		outFile << "\t\t\t\t<td>" << planets[i].GetMass() << " M<sub>E</sub></td>\n";
+		outFile << "\t\t\t\t<td>" << planets[i].GetRadius() << " R<sub>E</sub></td>\n";
+		outFile << "\t\t\t</tr>\n";
+	}
+	outFile << "\t\t\t</table>\n";
+
+
+	/*
+	 * FULL DETAILS
+	 */
+	for (size_t i = 0; i < planets.size(); i++) {
+		char planetNo = i + 98;
+		outFile << "\t\t<p>&nbsp;</p>\n";
+		outFile << "\t\t<table class=\"infobox\" id=\"" << hostName << " " << planetNo << "\">\n";
+		outFile << "\t\t\t<colgroup><col width=\"500\" /><col width=\"300\" /><col width=\"300\" /></colgroup>\n";
+		outFile << "\t\t\t<tr>\n\t\t\t\t<th colspan=\"3\">" << hostName << " " << planetNo << "</th>\n\t\t\t</tr>\n";
+
+		PlanetClass theClass = planets[i].GetPlanetClass();
+		const char * className;
+		const char * imgFileName;
+
+		printPlanetaryClass (theClass, className, imgFileName);
+
+		outFile << "\t\t\t<tr>\n";
+		outFile << "\t\t\t\t<td><strong>Planet type</strong></td>\n";
+		outFile << "\t\t\t\t<td><img src=\"../misc/" << imgFileName << "\" width=\"20\" />&nbsp;" << className << "</td>\n";
+		outFile << "\t\t\t</tr>\n";
+
+		outFile << "\t\t\t<tr>\n";
+		outFile << "\t\t\t\t<td><strong>Distance from star(s)</strong></td>\n";
+		outFile << "\t\t\t\t<td>" << planets[i].GetDistance() << " AU</td>\n";
+		outFile << "\t\t\t</tr>\n";
+		outFile << "\t\t\t<tr>\n";
+		outFile << "\t\t\t\t<td><strong>Orbital eccentricity</strong></td>\n";
+		outFile << "\t\t\t\t<td>" << planets[i].GetEccentricity() << "</td>\n";
+		outFile << "\t\t\t</tr>\n";
+
+		outFile << "\t\t\t<tr>\n";
+		outFile << "\t\t\t\t<td><strong>Orbital period</strong></td>\n";
+		outFile << "\t\t\t\t<td>" << planets[i].GetOrbitalPeriod() << " a</td>\n";
+		outFile << "\t\t\t\t<td>" << 365.25 * sqrt(pow(planets[i].GetDistance(), 3.0) / disk.hostStar.GetMass()) << " d</td>\n";
+		outFile << "\t\t\t</tr>\n";
+
+		outFile << "\t\t\t<tr>\n";
+		outFile << "\t\t\t\t<td><strong>Insolation</strong></td>\n";
+		outFile << "\t\t\t\t<td>" << disk.hostStar.GetLuminosity() / pow(planets[i].GetDistance(), 2.0) << "</td>\n";
+		outFile << "\t\t\t\t<td>" << 1321.0 * disk.hostStar.GetLuminosity() / pow(planets[i].GetDistance(), 2.0) << " W/m<sup>2</sup></td>\n";
+		outFile << "\t\t\t</tr>\n";
+
+		outFile << "\t\t\t<tr>\n";
+		outFile << "\t\t\t\t<td><strong>Mass</strong></td>\n";
+		outFile << "\t\t\t\t<td>" << planets[i].GetMass() << " M<sub>E</sub></td>\n";
+		outFile << "\t\t\t</tr>\n";
+
+		outFile << "\t\t\t<tr>\n";
+		outFile << "\t\t\t\t<td><strong>Radius</strong></td>\n";
+		outFile << "\t\t\t\t<td>" << planets[i].GetRadius() << " R<sub>E</sub></td>\n";
+		outFile << "\t\t\t\t<td>" << planets[i].GetRadius() * 6371.0 << " km</td>\n";
+		outFile << "\t\t\t</tr>\n";
+
+		outFile << "\t\t\t<tr>\n";
+		outFile << "\t\t\t\t<td><strong>Density</strong></td>\n";
+		outFile << "\t\t\t\t<td>" << planets[i].GetDensity() << " D<sub>E</sub></td>\n";
+		outFile << "\t\t\t\t<td>" << planets[i].GetDensity() * 5.52 << " g/cc</td>\n";
+		outFile << "\t\t\t</tr>\n";
+
+		outFile << "\t\t\t<tr>\n";
+		outFile << "\t\t\t\t<td><strong>Gravity</strong></td>\n";
+		outFile << "\t\t\t\t<td>" << planets[i].GetGravity() << " g</td>\n";
+		outFile << "\t\t\t</tr>\n";
+
+		outFile << "\t\t\t<tr>\n";
+		outFile << "\t\t\t\t<td><strong>Siderial rotation period</strong></td>\n";
+		outFile << "\t\t\t\t<td>" << planets[i].GetRotationPeriod() << " h</td>\n";
+		outFile << "\t\t\t\t<td>" << planets[i].GetRotationPeriod() / 24.0 << " d</td>\n";
+		outFile << "\t\t\t</tr>\n";
+
+		outFile << "\t\t\t<tr>\n";
+		outFile << "\t\t\t\t<td><strong>Axial tilt</strong></td>\n";
+		outFile << "\t\t\t\t<td>" << planets[i].GetAxialTilt() << "&deg;</td>\n";
+		outFile << "\t\t\t</tr>\n";
+
+		if (theClass == TERRESTRIAL_PLANET || theClass == LEFTOVER_OLIGARCH || theClass == VENUSIAN || theClass == HYCEAN || theClass == TITANIAN || theClass == GAIAN || theClass == MARTIAN) {
+			outFile << "\t\t\t<tr>\n";
+			outFile << "\t\t\t\t<td><strong>Albedo</strong></td>\n";
+			outFile << "\t\t\t\t<td>" << planets[i].GetAlbedo() << " (Bond)</td>\n";
+			outFile << "\t\t\t</tr>\n";
+
+			outFile << "\t\t\t<tr>\n";
+			outFile << "\t\t\t\t<td><strong>Hydrographic coverage</strong></td>\n";
+			outFile << "\t\t\t\t<td>" << planets[i].GetOceanPct() * 100.0 << "%</td>\n";
+			outFile << "\t\t\t</tr>\n";
+
+			outFile << "\t\t\t<tr>\n";
+			outFile << "\t\t\t\t<td><strong>Atmosphere</strong></td>\n";
+			const Atmosphere & a = planets[i].GetAtmosphere();
+			outFile << "\t\t\t\t<td>" << a.pressure << " atm</td>\n";
+			outFile << setprecision(4) << "\t\t\t\t<td>";
+			if (a.hydrogen != 0) { outFile << "Hydrogen: " << a.hydrogen * 100.0 << "%<br />"; }
+			if (a.helium != 0) { outFile << "Helium: " << a.helium * 100.0 << "%<br />"; }
+			if (a.nitrogen != 0) { outFile << "Nitrogen: " << a.nitrogen * 100.0 << "%<br />"; }
+			if (a.argon != 0) { outFile << "Argon: " << a.argon * 100.0 << "%<br />"; }
+			if (a.carbonDioxide != 0) { outFile << "Carbon dioxide: " << a.carbonDioxide * 100.0 << "%<br />"; }
+			if (a.oxygen != 0) { outFile << "Oxygen: " << a.oxygen * 100.0 << "%<br />"; }
+			if (a.waterVapor != 0) { outFile << "Water vapor: " << a.waterVapor * 100.0 << "%<br />"; }
+			outFile << setprecision(6) << "</td>\n";
+			outFile << "\t\t\t</tr>\n";
+		}
+
+		outFile << "\t\t\t<tr>\n";
+		outFile << "\t\t\t\t<td><strong>Surface temperature</strong></td>\n";
+		outFile << "\t\t\t\t<td>" << planets[i].GetTemperature() << " K</td>\n";
+		outFile << "\t\t\t\t<td>" << planets[i].GetTemperature() - 273.15 << " &deg;C<br />";
+		outFile << (planets[i].GetTemperature() - 273.15) * 1.8 + 32.0 << " &deg;F</td>\n";
+		outFile << "\t\t\t</tr>\n";
+
+		outFile << "\t\t</table>\n\n";
+
+		if (planets[i].GetNumberOfMoons() != 0) {
+			outFile << "\t\t<table class=\"infobox\">\n";
+			outFile << "\t\t\t<colgroup><col width=\"50\" /><col width=\"300\" /><col width=\"300\" /></colgroup>\n";
+			outFile << "\t\t\t<tr>\n\t\t\t\t<th>&numero;</th><th>Distance</th><th>Mass</th>\n";
+			const std::array<Moon, 10> & theMoons = planets[i].GetMoons();
+			int moonCount = planets[i].GetNumberOfMoons();
+			for (int j = 0; j < moonCount; j++) {
+				outFile << "\t\t\t<tr>\n\t\t\t\t<td>" << j + 1 << "</td>\n";
+				outFile << "\t\t\t\t<td>" << setprecision(9) << theMoons[j].GetDistance() << " km</td>\n";
+				outFile << "\t\t\t\t<td>" << setprecision(6) << theMoons[j].GetMass() << " M<sub>E</sub><br />";
+				outFile << theMoons[j].GetMass() / 0.0123 << " M<sub>Moon</sub></td>\n";
+				outFile << "\t\t\t</tr>\n";
+			}
+			outFile << "\t\t</table>\n\n";
+		}
+	}
+
+}
+
+void printPlanetaryClass (PlanetClass pc, const char * & className, const char * & imgFileName) {
+	switch(pc) {
+		case NONE:
+			className = "None";
+			imgFileName = "";
+			break;
+		case FAILED_CORE:
+			className = "Failed core";
+			imgFileName = "GasDwarfPlanet.gif";
+			break;
+		case SMALL_GAS_GIANT:
+			className = "Small gas giant";
+			imgFileName = "Sub-JovianPlanet.gif";
+			break;
+		case MEDIUM_GAS_GIANT:
+			className = "Medium gas giant";
+			imgFileName = "JovianPlanet.gif";
+			break;
+		case LARGE_GAS_GIANT:
+			className = "Large gas giant";
+			imgFileName = "JovianPlanet.gif";
+			break;
+		case TERRESTRIAL_PLANET:
+			className = "Terrestrial planet";
+			imgFileName = "RockPlanet.gif";
+			break;
+		case PLANETOID_BELT:
+			className = "Planetoid belt";
+			imgFileName = "AsteroidsPlanet.gif";
+			break;
+		case LEFTOVER_OLIGARCH:
+			className = "Leftover oligarch";
+			imgFileName = "1FacePlanet.gif";
+			break;
+		case VENUSIAN:
+			className = "Venusian";
+			imgFileName = "VenusianPlanet.gif";
+			break;
+		case HYCEAN:
+			className = "Hycean";
+			imgFileName = "WaterPlanet.gif";
+			break;
+		case TITANIAN:
+			className = "Titanian";
+			imgFileName = "TitanianPlanet.gif";
+			break;
+		case GAIAN:
+			className = "Gaian";
+			imgFileName = "GaianPlanet.gif";
+			break;
+		case MARTIAN:
+			className = "Martian";
+			imgFileName = "MartianPlanet.gif";
+			break;
+	}
+}
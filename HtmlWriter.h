@@ -0,0 +1,13 @@
+#ifndef HTMLWRITER_H
+#define HTMLWRITER_H
+
+#include <iostream>
+#include <string>
+#include "Planet.h"
+#include "StarSystem.h"
+using namespace std;
+
+void WriteSystemHtml (ostream & outFile, StarSystem & system);
+void printPlanetaryClass (PlanetClass pc, const char * & className, const char * & imgFileName);
+
+#endif // HTMLWRITER_H
@@ -0,0 +1,344 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <system_error>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "Generator.h"
+#include "HtmlWriter.h"
+#include "JsonWriter.h"
+#include "LruCache.h"
+#include "RandomEngine.h"
+#include "HttpServer.h"
+using namespace std;
+
+// Function declarations
+bool sendAll (int fd, const string & data);
+bool parseSystemPath (const string & path, int & seed, string & extension);
+
+// requests larger than this are refused rather than buffered
+const size_t MAX_REQUEST_BYTES = 16384;
+
+// connections open at once, each with its own thread; more are sent a 503
+const int MAX_CONNECTIONS = 256;
+
+HttpServer::HttpServer(GenerationOptions o, size_t cacheBytes) : options(o), cache(cacheBytes)
+{
+	listenFd = -1;
+}
+
+///////////////////////////////////////
+// MUTATORS
+///////////////////////////////////////
+
+/* Listen
+ * Binds to an IPv4 "ADDRESS:PORT"; returns false (with errno set) on failure
+ */
+bool HttpServer::Listen (string address) {
+	size_t colon = address.rfind(':');
+	if (colon == string::npos) {
+		errno = EINVAL;
+		return false;
+	}
+	string host = address.substr(0, colon);
+	int port = atoi(address.substr(colon + 1).c_str());
+
+	sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(port);
+	if (port <= 0 || port > 65535 || inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) {
+		errno = EINVAL;
+		return false;
+	}
+
+	listenFd = socket(AF_INET, SOCK_STREAM, 0);
+	if (listenFd < 0) { return false; }
+
+	int yes = 1;
+	setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+	if (bind(listenFd, (sockaddr *) &addr, sizeof(addr)) < 0 || listen(listenFd, 128) < 0) {
+		close(listenFd);
+		listenFd = -1;
+		return false;
+	}
+
+	return true;
+}
+
+/* Run
+ * Accepts connections forever, each on a thread of its own while fewer than
+ * MAX_CONNECTIONS are open; one over the limit, or one whose thread cannot
+ * be started, is answered 503 and closed
+ */
+void HttpServer::Run () {
+	while (true) {
+		int fd = accept(listenFd, NULL, NULL);
+		if (fd < 0) { continue; }
+
+		if (openConnections.fetch_add(1) >= MAX_CONNECTIONS) {
+			refuseConnection(fd);
+			continue;
+		}
+		try {
+			thread([this, fd]() {
+				handleConnection(fd);
+				openConnections--;
+			}).detach();
+		}
+		catch (const system_error &) {
+			refuseConnection(fd);
+		}
+	}
+}
+
+// Answers a connection that was counted in openConnections but got no thread
+void HttpServer::refuseConnection (int fd) {
+	openConnections--;
+	refusedConnections++;
+	sendAll(fd, "HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\nRetry-After: 1\r\nConnection: close\r\n\r\n");
+	close(fd);
+}
+
+void HttpServer::handleConnection (int fd) {
+	// don't let an idle keep-alive connection hold its thread forever
+	timeval timeout;
+	timeout.tv_sec = 30;
+	timeout.tv_usec = 0;
+	setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+	string buffer;
+	char chunk[4096];
+	bool keepAlive = true;
+
+	while (keepAlive) {
+		// read one request head
+		size_t headEnd;
+		while ((headEnd = buffer.find("\r\n\r\n")) == string::npos) {
+			if (buffer.size() > MAX_REQUEST_BYTES) {
+				sendAll(fd, "HTTP/1.1 431 Request Header Fields Too Large\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+				close(fd);
+				return;
+			}
+			ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+			if (n <= 0) {
+				close(fd);
+				return;
+			}
+			buffer.append(chunk, n);
+		}
+		string head = buffer.substr(0, headEnd);
+		buffer.erase(0, headEnd + 4);
+
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+		istringstream headStream(head);
+		string method, path, httpVersion;
+		headStream >> method >> path >> httpVersion;
+
+		// HTTP/1.0 closes by default, HTTP/1.1 keeps alive by default
+		keepAlive = (httpVersion == "HTTP/1.1");
+		string line;
+		while (getline(headStream, line)) {
+			string lower = line;
+			for (size_t i = 0; i < lower.size(); i++) { lower[i] = tolower(lower[i]); }
+			if (lower.compare(0, 11, "connection:") == 0) {
+				if (lower.find("close") != string::npos) { keepAlive = false; }
+				else if (lower.find("keep-alive") != string::npos) { keepAlive = true; }
+			}
+			// request bodies are not supported, so don't try to find the next request after one
+			if (lower.compare(0, 15, "content-length:") == 0 && atol(lower.c_str() + 15) > 0) { keepAlive = false; }
+		}
+
+		int status = 200;
+		string contentType;
+		shared_ptr<const string> body;
+		bool cacheHit = false;
+		Endpoint endpoint = route(method, path, status, contentType, body, cacheHit);
+
+		string statusText = "OK";
+		if (status == 404) { statusText = "Not Found"; }
+		else if (status == 405) { statusText = "Method Not Allowed"; }
+
+		ostringstream response;
+		response << "HTTP/1.1 " << status << " " << statusText << "\r\n";
+		response << "Content-Type: " << contentType << "\r\n";
+		response << "Content-Length: " << body->size() << "\r\n";
+		if (status == 405) { response << "Allow: GET, HEAD\r\n"; }
+		if (endpoint == HTML_ENDPOINT || endpoint == JSON_ENDPOINT) {
+			response << "X-Cache: " << (cacheHit ? "HIT" : "MISS") << "\r\n";
+		}
+		response << "Connection: " << (keepAlive ? "keep-alive" : "close") << "\r\n\r\n";
+
+		bool sent = sendAll(fd, response.str());
+		if (sent && method != "HEAD") { sent = sendAll(fd, *body); }
+
+		unsigned long micros = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+		recordLatency(endpoint, micros, status == 200 && endpoint != STATS_ENDPOINT, cacheHit);
+
+		if (!sent) { break; }
+	}
+
+	close(fd);
+}
+
+HttpServer::Endpoint HttpServer::route (const string & method, const string & path, int & status, string & contentType, shared_ptr<const string> & body, bool & cacheHit) {
+	contentType = "text/plain; charset=utf-8";
+
+	int seed;
+	string extension;
+	Endpoint endpoint = OTHER_ENDPOINT;
+	if (path == "/stats") { endpoint = STATS_ENDPOINT; }
+	else if (parseSystemPath(path, seed, extension)) {
+		if (extension == "html") { endpoint = HTML_ENDPOINT; }
+		else if (extension == "json") { endpoint = JSON_ENDPOINT; }
+	}
+
+	if (method != "GET" && method != "HEAD") {
+		status = 405;
+		body = make_shared<const string>("Method not allowed\n");
+		return endpoint;
+	}
+
+	if (endpoint == STATS_ENDPOINT) {
+		status = 200;
+		contentType = "application/json";
+		body = make_shared<const string>(statsJson());
+	}
+	else if (endpoint == HTML_ENDPOINT || endpoint == JSON_ENDPOINT) {
+		bool asJson = (endpoint == JSON_ENDPOINT);
+		string key = VERSION_NUMBER + "/" + to_string(seed) + "." + extension;
+
+		status = 200;
+		contentType = asJson ? "application/json" : "text/html; charset=utf-8";
+		body = cache.Get(key);
+		cacheHit = (body != nullptr);
+		if (!cacheHit) {
+			body = renderSystem(seed, asJson);
+			cache.Put(key, body);
+		}
+	}
+	else {
+		status = 404;
+		body = make_shared<const string>("Not found\n");
+	}
+
+	return endpoint;
+}
+
+shared_ptr<const string> HttpServer::renderSystem (int seed, bool asJson) {
+	unsigned long long draws = randomDrawCount;
+	StarSystem system = GenerateSystem(seed, options);
+	recordDraws(seed, randomDrawCount - draws);
+
+	ostringstream out;
+	if (asJson) { WriteSystemJson(out, system); }
+	else { WriteSystemHtml(out, system); }
+
+	return make_shared<const string>(out.str());
+}
+
+string HttpServer::statsJson () {
+	const char * names[ENDPOINT_COUNT] = {"html", "json", "stats", "other"};
+
+	ostringstream out;
+	out << "{\"version\":";
+	writeJsonString(out, VERSION_NUMBER);
+	out << ",\"cache\":{\"entries\":" << cache.GetEntryCount();
+	out << ",\"bytes\":" << cache.GetByteCount();
+	out << ",\"capacityBytes\":" << cache.GetCapacity();
+	out << ",\"evictions\":" << cache.GetEvictionCount() << "}";
+	out << ",\"connections\":{\"open\":" << openConnections << ",\"refused\":" << refusedConnections << "}";
+	out << ",\"endpoints\":{";
+	for (int e = 0; e < ENDPOINT_COUNT; e++) {
+		unsigned long requests = stats[e].requests;
+		unsigned long hits = stats[e].hits;
+		unsigned long misses = stats[e].misses;
+
+		if (e != 0) { out << ","; }
+		out << "\"" << names[e] << "\":{\"requests\":" << requests;
+		out << ",\"hits\":" << hits << ",\"misses\":" << misses;
+		out << ",\"hitRate\":";
+		writeJsonNumber(out, hits + misses == 0 ? 0.0 : (double) hits / (hits + misses));
+		out << ",\"meanMicros\":";
+		writeJsonNumber(out, requests == 0 ? 0.0 : (double) stats[e].totalMicros / requests);
+		out << ",\"maxMicros\":" << stats[e].maxMicros << "}";
+	}
+	out << "}";
+
+	unsigned long long systems = drawStats.systems;
+	unsigned long long most = drawStats.most;
+	out << ",\"draws\":{\"systems\":" << systems << ",\"mean\":";
+	writeJsonNumber(out, systems == 0 ? 0.0 : (double) drawStats.draws / systems);
+	out << ",\"max\":" << (most >> 32) << ",\"maxSeed\":" << (int) (uint32_t) most << "}";
+	out << "}";
+
+	return out.str();
+}
+
+void HttpServer::recordLatency (Endpoint e, unsigned long micros, bool wasCacheable, bool cacheHit) {
+	stats[e].requests++;
+	stats[e].totalMicros += micros;
+	if (wasCacheable) {
+		if (cacheHit) { stats[e].hits++; }
+		else { stats[e].misses++; }
+	}
+
+	unsigned long seen = stats[e].maxMicros;
+	while (micros > seen && !stats[e].maxMicros.compare_exchange_weak(seen, micros)) { }
+}
+
+// Counts the DRAWS a generated system took, and remembers SEED if it took the most
+void HttpServer::recordDraws (int seed, unsigned long long draws) {
+	drawStats.systems++;
+	drawStats.draws += draws;
+
+	if (draws > 0xffffffffULL) { draws = 0xffffffffULL; }
+	unsigned long long packed = (draws << 32) | (uint32_t) seed;
+	unsigned long long seen = drawStats.most;
+	while ((packed >> 32) > (seen >> 32) && !drawStats.most.compare_exchange_weak(seen, packed)) { }
+}
+
+///////////////////////////////////////
+// HELPERS
+///////////////////////////////////////
+
+bool sendAll (int fd, const string & data) {
+	size_t sent = 0;
+	while (sent < data.size()) {
+		ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+		if (n <= 0) { return false; }
+		sent += n;
+	}
+	return true;
+}
+
+/* parseSystemPath
+ * Accepts exactly "/system/<integer seed>.<extension>"
+ */
+bool parseSystemPath (const string & path, int & seed, string & extension) {
+	const string prefix = "/system/";
+	if (path.compare(0, prefix.size(), prefix) != 0) { return false; }
+
+	size_t dot = path.rfind('.');
+	if (dot == string::npos || dot <= prefix.size()) { return false; }
+
+	string seedText = path.substr(prefix.size(), dot - prefix.size());
+	char * end;
+	errno = 0;
+	long value = strtol(seedText.c_str(), &end, 10);
+	if (*end != '\0' || errno != 0 || value < INT32_MIN || value > INT32_MAX) { return false; }
+
+	seed = value;
+	extension = path.substr(dot + 1);
+	return true;
+}
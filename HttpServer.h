@@ -0,0 +1,69 @@
+#ifndef HTTPSERVER_H
+#define HTTPSERVER_H
+
+#include <string>
+#include <memory>
+#include <atomic>
+#include "Generator.h"
+#include "LruCache.h"
+using namespace std;
+
+/* HttpServer
+ * Minimal HTTP/1.1 front end for the generator
+ *   GET /system/<seed>.html   the page the command line writes to disk
+ *   GET /system/<seed>.json   the same system as JSON
+ *   GET /stats                cache, connection and per-endpoint latency
+ *                             counters, and the random draws each generated
+ *                             system took
+ * Rendered pages are kept in an LRU cache keyed by version, seed and format.
+ * Every connection gets its own thread, up to a limit past which new ones
+ * are answered 503; connections are kept alive unless the client asks
+ * otherwise.
+ */
+class HttpServer
+{
+	public:
+		// Constructors
+		HttpServer(GenerationOptions o, size_t cacheBytes);
+		// Mutators
+		bool Listen (string address);
+		void Run ();
+	protected:
+	private:
+		enum Endpoint { HTML_ENDPOINT, JSON_ENDPOINT, STATS_ENDPOINT, OTHER_ENDPOINT, ENDPOINT_COUNT };
+
+		// counters are only ever added to, so they need no lock
+		struct EndpointStats {
+			atomic<unsigned long> requests{0};
+			atomic<unsigned long> hits{0};
+			atomic<unsigned long> misses{0};
+			atomic<unsigned long> totalMicros{0};
+			atomic<unsigned long> maxMicros{0};
+		};
+
+		// the most draws any system took is packed with its seed, draws in the
+		// high half, so one compare-exchange keeps the two together
+		struct DrawStats {
+			atomic<unsigned long long> systems{0};
+			atomic<unsigned long long> draws{0};
+			atomic<unsigned long long> most{0};
+		};
+
+		void handleConnection (int fd);
+		void refuseConnection (int fd);
+		Endpoint route (const string & method, const string & path, int & status, string & contentType, shared_ptr<const string> & body, bool & cacheHit);
+		shared_ptr<const string> renderSystem (int seed, bool asJson);
+		string statsJson ();
+		void recordLatency (Endpoint e, unsigned long micros, bool wasCacheable, bool cacheHit);
+		void recordDraws (int seed, unsigned long long draws);
+
+		GenerationOptions options;
+		LruCache cache;
+		int listenFd;
+		atomic<int> openConnections{0};
+		atomic<unsigned long> refusedConnections{0};
+		EndpointStats stats[ENDPOINT_COUNT];
+		DrawStats drawStats;
+};
+
+#endif // HTTPSERVER_H
@@ -0,0 +1,206 @@
+#include <iostream>
+#include <array>
+#include <string>
+#include <vector>
+#include <cmath>            // isfinite
+#include <cstdio>           // snprintf
+#include "Star.h"
+#include "Planet.h"
+#include "Moon.h"
+#include "StarSystem.h"
+#include "Generator.h"
+#include "HtmlWriter.h"
+#include "JsonWriter.h"
+using namespace std;
+
+// Function declarations
+void writeStarJson (ostream & out, const string & name, const Star & s);
+void writeOrbitJson (ostream & out, string primary, string companion, OverallSeparation & orbit);
+void writePlanetJson (ostream & out, const Planet & p);
+
+/* WriteSystemJson
+ * Writes a generated system as a single JSON object (no trailing newline)
+ * Numbers are written with enough digits to read back exactly.
+ */
+void WriteSystemJson (ostream & out, StarSystem & system) {
+	out << "{\"seed\":" << system.seed;
+	out << ",\"version\":";
+	writeJsonString(out, VERSION_NUMBER);
+	out << ",\"multiplicity\":" << system.GetMultiplicity();
+	out << ",\"hierarchy\":";
+	writeJsonString(out, system.DescribeHierarchy(system.root));
+
+	// stars
+	out << ",\"stars\":[";
+	for (size_t i = 0; i < system.stars.size(); i++) {
+		if (i != 0) { out << ","; }
+		writeStarJson(out, string(1, (char) ('A' + i)), system.stars[i]);
+	}
+	out << "]";
+
+	// orbits, innermost first
+	out << ",\"orbits\":[";
+	pmr::vector<int> pairs(systemMemory());
+	system.GetOrbitsInnermostFirst(system.root, pairs);
+	for (size_t i = 0; i < pairs.size(); i++) {
+		StellarNode & pair = system.nodes[pairs[i]];
+		if (i != 0) { out << ","; }
+		writeOrbitJson(out, system.nodes[pair.primary].name, system.nodes[pair.companion].name, pair.orbit);
+	}
+	out << "]";
+
+	// one entry per disk
+	out << ",\"planetSystems\":[";
+	for (size_t d = 0; d < system.planetSystems.size(); d++) {
+		PlanetarySystem & disk = system.planetSystems[d];
+		if (d != 0) { out << ","; }
+		out << "{\"host\":";
+		writeJsonString(out, system.nodes[disk.host].name);
+		out << ",\"circumbinary\":" << (disk.circumbinary ? "true" : "false");
+		out << ",\"forbiddenZone\":";
+		writeJsonNumber(out, disk.forbiddenZone);
+		out << ",\"planets\":[";
+		for (size_t i = 0; i < disk.planets.size(); i++) {
+			if (i != 0) { out << ","; }
+			writePlanetJson(out, disk.planets[i]);
+		}
+		out << "]}";
+	}
+	out << "]}";
+}
+
+void writePlanetJson (ostream & out, const Planet & p) {
+	const char * className;
+	const char * imgFileName;
+	printPlanetaryClass(p.GetPlanetClass(), className, imgFileName);
+
+	out << "{\"class\":";
+	writeJsonString(out, className);
+	out << ",\"distance\":";
+	writeJsonNumber(out, p.GetDistance());
+	out << ",\"eccentricity\":";
+	writeJsonNumber(out, p.GetEccentricity());
+	out << ",\"mass\":";
+	writeJsonNumber(out, p.GetMass());
+	out << ",\"radius\":";
+	writeJsonNumber(out, p.GetRadius());
+	out << ",\"density\":";
+	writeJsonNumber(out, p.GetDensity());
+	out << ",\"gravity\":";
+	writeJsonNumber(out, p.GetGravity());
+	out << ",\"orbitalPeriod\":";
+	writeJsonNumber(out, p.GetOrbitalPeriod());
+	out << ",\"rotationPeriod\":";
+	writeJsonNumber(out, p.GetRotationPeriod());
+	out << ",\"axialTilt\":";
+	writeJsonNumber(out, p.GetAxialTilt());
+	out << ",\"albedo\":";
+	writeJsonNumber(out, p.GetAlbedo());
+	out << ",\"oceanPct\":";
+	writeJsonNumber(out, p.GetOceanPct());
+	out << ",\"temperature\":";
+	writeJsonNumber(out, p.GetTemperature());
+
+	const Atmosphere & a = p.GetAtmosphere();
+	out << ",\"atmosphere\":{\"pressure\":";
+	writeJsonNumber(out, a.pressure);
+	out << ",\"hydrogen\":";
+	writeJsonNumber(out, a.hydrogen);
+	out << ",\"helium\":";
+	writeJsonNumber(out, a.helium);
+	out << ",\"nitrogen\":";
+	writeJsonNumber(out, a.nitrogen);
+	out << ",\"argon\":";
+	writeJsonNumber(out, a.argon);
+	out << ",\"carbonDioxide\":";
+	writeJsonNumber(out, a.carbonDioxide);
+	out << ",\"oxygen\":";
+	writeJsonNumber(out, a.oxygen);
+	out << ",\"waterVapor\":";
+	writeJsonNumber(out, a.waterVapor);
+	out << "}";
+
+	out << ",\"moons\":[";
+	const std::array<Moon, 10> & theMoons = p.GetMoons();
+	for (int j = 0; j < p.GetNumberOfMoons(); j++) {
+		if (j != 0) { out << ","; }
+		out << "{\"distance\":";
+		writeJsonNumber(out, theMoons[j].GetDistance());
+		out << ",\"mass\":";
+		writeJsonNumber(out, theMoons[j].GetMass());
+		out << "}";
+	}
+	out << "]}";
+}
+
+void writeStarJson (ostream & out, const string & name, const Star & s) {
+	out << "{\"name\":";
+	writeJsonString(out, name);
+	out << ",\"spectralType\":";
+	writeJsonString(out, spectralTypeName(s.GetSpectralType()));
+	out << ",\"luminosityClass\":";
+	writeJsonString(out, luminosityClassName(s.GetLuminosityClass()));
+	out << ",\"mass\":";
+	writeJsonNumber(out, s.GetMass());
+	out << ",\"radius\":";
+	writeJsonNumber(out, s.GetRadius());
+	out << ",\"luminosity\":";
+	writeJsonNumber(out, s.GetLuminosity());
+	out << ",\"temperature\":";
+	writeJsonNumber(out, s.GetTemperature());
+	out << ",\"age\":";
+	writeJsonNumber(out, s.GetAge());
+	out << ",\"metallicity\":";
+	writeJsonNumber(out, s.GetMetallicity());
+	out << "}";
+}
+
+void writeOrbitJson (ostream & out, string primary, string companion, OverallSeparation & orbit) {
+	out << "{\"primary\":";
+	writeJsonString(out, primary);
+	out << ",\"companion\":";
+	writeJsonString(out, companion);
+	out << ",\"separation\":";
+	writeJsonNumber(out, orbit.separation);
+	out << ",\"eccentricity\":";
+	writeJsonNumber(out, orbit.eccentricity);
+	out << "}";
+}
+
+/* writeJsonString
+ * Writes s as a quoted JSON string, escaping quotes, backslashes and control characters
+ */
+void writeJsonString (ostream & out, const string & s) {
+	out << '"';
+	for (size_t i = 0; i < s.size(); i++) {
+		char c = s[i];
+		switch (c) {
+			case '"': out << "\\\""; break;
+			case '\\': out << "\\\\"; break;
+			case '\n': out << "\\n"; break;
+			case '\r': out << "\\r"; break;
+			case '\t': out << "\\t"; break;
+			default:
+				if ((unsigned char) c < 0x20) {
+					char escaped[8];
+					snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+					out << escaped;
+				}
+				else { out << c; }
+		}
+	}
+	out << '"';
+}
+
+/* writeJsonNumber
+ * JSON has no NaN or infinity, so those are written as null
+ */
+void writeJsonNumber (ostream & out, double d) {
+	if (!isfinite(d)) {
+		out << "null";
+		return;
+	}
+	char number[32];
+	snprintf(number, sizeof(number), "%.17g", d);
+	out << number;
+}
@@ -0,0 +1,13 @@
+#ifndef JSONWRITER_H
+#define JSONWRITER_H
+
+#include <iostream>
+#include <string>
+#include "StarSystem.h"
+using namespace std;
+
+void WriteSystemJson (ostream & out, StarSystem & system);
+void writeJsonString (ostream & out, const string & s);
+void writeJsonNumber (ostream & out, double d);
+
+#endif // JSONWRITER_H
@@ -0,0 +1,30 @@
+#include <iostream>
+#include <atomic>
+#include "Log.h"
+using namespace std;
+
+static atomic<ostream *> defaultLogStream(&cout);
+// one stream per thread; null until a worker redirects it
+static thread_local ostream * currentLogStream = nullptr;
+static atomic<int> currentLogLevel(LOG_INFO);
+
+ostream & logStream () {
+	if (currentLogStream != nullptr) { return *currentLogStream; }
+	return *defaultLogStream;
+}
+
+void setLogStream (ostream & out) {
+	currentLogStream = &out;
+}
+
+void setDefaultLogStream (ostream & out) {
+	defaultLogStream = &out;
+}
+
+int getLogLevel () {
+	return currentLogLevel.load(memory_order_relaxed);
+}
+
+void setLogLevel (int level) {
+	currentLogLevel.store(level, memory_order_relaxed);
+}
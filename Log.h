@@ -0,0 +1,38 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <iostream>
+using namespace std;
+
+// Diagnostics from the generator go through logStream() instead of cout so
+// that each worker thread can collect the output of the system it is working on.
+ostream & logStream ();
+void setLogStream (ostream & out);
+// where threads that never called setLogStream write (cout to begin with)
+void setDefaultLogStream (ostream & out);
+
+/* Log levels
+ * LOG_INFO is shown by default, LOG_DEBUG with -v and LOG_TRACE with -vv;
+ * -q sets the level to LOG_QUIET and shows nothing.
+ */
+enum LogLevel { LOG_QUIET = 0, LOG_INFO = 1, LOG_DEBUG = 2, LOG_TRACE = 3 };
+
+int getLogLevel ();
+void setLogLevel (int level);
+
+// Statements above this level are compiled out entirely, arguments and all:
+// build with "make LOG_LEVEL=1" for a release that only keeps LOG_INFO.
+#ifndef LOG_COMPILED_LEVEL
+#define LOG_COMPILED_LEVEL LOG_TRACE
+#endif
+
+/* LOG
+ * Usage: LOG(LOG_DEBUG) << "mass: " << mass << "\n";
+ * The stream expression is only evaluated when the level is enabled.  Written
+ * as if/else so that it is safe inside an unbraced if.
+ */
+#define LOG(level) \
+	if ((level) > LOG_COMPILED_LEVEL || (level) > getLogLevel()) {} \
+	else logStream()
+
+#endif // LOG_H
@@ -0,0 +1,78 @@
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include "LruCache.h"
+using namespace std;
+
+LruCache::LruCache(size_t maxBytes)
+{
+	capacity = maxBytes;
+	bytes = 0;
+	evictions = 0;
+}
+
+///////////////////////////////////////
+// ACCESSORS
+///////////////////////////////////////
+
+// Returns null on a miss; a hit becomes the most recently used entry
+shared_ptr<const string> LruCache::Get (const string & key) {
+	lock_guard<mutex> guard(cacheLock);
+
+	unordered_map<string, EntryList::iterator>::iterator found = index.find(key);
+	if (found == index.end()) { return nullptr; }
+
+	entries.splice(entries.begin(), entries, found->second);
+	return found->second->second;
+}
+
+size_t LruCache::GetEntryCount () {
+	lock_guard<mutex> guard(cacheLock);
+	return entries.size();
+}
+
+size_t LruCache::GetByteCount () {
+	lock_guard<mutex> guard(cacheLock);
+	return bytes;
+}
+
+size_t LruCache::GetCapacity () {
+	return capacity;
+}
+
+unsigned long LruCache::GetEvictionCount () {
+	lock_guard<mutex> guard(cacheLock);
+	return evictions;
+}
+
+///////////////////////////////////////
+// MUTATORS
+///////////////////////////////////////
+
+void LruCache::Put (const string & key, shared_ptr<const string> value) {
+	// a value bigger than the whole cache would only evict everything else
+	if (value->size() > capacity) { return; }
+
+	lock_guard<mutex> guard(cacheLock);
+
+	unordered_map<string, EntryList::iterator>::iterator found = index.find(key);
+	if (found != index.end()) {
+		bytes -= found->second->second->size();
+		entries.erase(found->second);
+		index.erase(found);
+	}
+
+	entries.push_front(make_pair(key, value));
+	index[key] = entries.begin();
+	bytes += value->size();
+
+	while (bytes > capacity) {
+		EntryList::iterator last = prev(entries.end());
+		bytes -= last->second->size();
+		index.erase(last->first);
+		entries.erase(last);
+		evictions++;
+	}
+}
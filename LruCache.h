@@ -0,0 +1,42 @@
+#ifndef LRUCACHE_H
+#define LRUCACHE_H
+
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+using namespace std;
+
+/* LruCache
+ * Thread-safe, size-bounded cache of rendered pages
+ * The bound is on the total length of the stored values; once it is passed,
+ * the least recently used entries are evicted.  Values are shared, so a
+ * reader keeps its copy even if the entry is evicted while it is being sent.
+ */
+class LruCache
+{
+	public:
+		// Constructors
+		LruCache(size_t maxBytes);
+		// Accessors
+		shared_ptr<const string> Get (const string & key);
+		size_t GetEntryCount ();
+		size_t GetByteCount ();
+		size_t GetCapacity ();
+		unsigned long GetEvictionCount ();
+		// Mutators
+		void Put (const string & key, shared_ptr<const string> value);
+	protected:
+	private:
+		typedef list<pair<string, shared_ptr<const string>>> EntryList;
+
+		mutex cacheLock;
+		size_t capacity; // in bytes
+		size_t bytes; // bytes currently stored
+		unsigned long evictions;
+		EntryList entries; // most recently used first
+		unordered_map<string, EntryList::iterator> index;
+};
+
+#endif // LRUCACHE_H
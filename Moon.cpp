@@ -23,31 +23,38 @@ Moon::Moon(double d, double m) {
 	mass = m;
 }
 
+#ifdef COUNT_COPIES
+// the copy benchmark's counted copy; see CopyCounter.h
+Moon::Moon(const Moon & other) {
+	copyCounted(*this, other);
+}
+#endif
+
 ///////////////////////////////////////
 // ACCESSORS
 ///////////////////////////////////////
 
-double Moon::GetDistance () {
+double Moon::GetDistance () const {
 	return distance;
 }
 
-double Moon::GetEccentricity () {
+double Moon::GetEccentricity () const {
 	return eccentricity;
 }
 
-double Moon::GetMass () {
+double Moon::GetMass () const {
 	return mass;
 }
 
-double Moon::GetRadius () {
+double Moon::GetRadius () const {
 	return radius;
 }
 
-double Moon::GetDensity () {
+double Moon::GetDensity () const {
 	return density;
 }
 
-double Moon::GetGravity () {
+double Moon::GetGravity () const {
 	return gravity;
 }
 ///////////////////////////////////////
@@ -80,6 +87,12 @@ void Moon::SetGravity (double g) {
 ///////////////////////////////////////
 // OPERATORS
 ///////////////////////////////////////
+#ifdef COUNT_COPIES
+Moon & Moon::operator=(const Moon & rhs) {
+	copyCounted(*this, rhs);
+	return *this;
+}
+#endif
 
 /*bool operator==(Moon a, Moon b) {
 	return (a.mass == b.mass) && (a.age == b.age) && (a.metallicity == b.metallicity) && (a.temperature == b.temperature) && (a.luminosity == b.luminosity) && (a.radius == b.radius);
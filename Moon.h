@@ -2,6 +2,9 @@
 #define MOON_H
 
 #include <iostream>
+#ifdef COUNT_COPIES
+#include "CopyCounter.h"
+#endif
 using namespace std;
 
 class Moon
@@ -9,16 +12,18 @@ class Moon
 	public:
 		// Constructors
 		Moon();
-		//Moon(const Moon & other);
+#ifdef COUNT_COPIES
+		Moon(const Moon & other);
+#endif
 		Moon(double d);
 		Moon(double d, double m);
 		// Accessors
-		double GetDistance ();
-		double GetEccentricity ();
-		double GetMass ();
-		double GetRadius ();
-		double GetDensity ();
-		double GetGravity ();
+		double GetDistance () const;
+		double GetEccentricity () const;
+		double GetMass () const;
+		double GetRadius () const;
+		double GetDensity () const;
+		double GetGravity () const;
 		// Mutators
 		void SetDistance (double d);
 		void SetEccentricity (double e);
@@ -27,7 +32,9 @@ class Moon
 		void SetDensity (double rho);
 		void SetGravity (double g);
 		// Operators
-		//Moon & operator=(const Moon & rhs);
+#ifdef COUNT_COPIES
+		Moon & operator=(const Moon & rhs);
+#endif
 		//bool operator==(Moon m);
 	protected:
 	private:
@@ -0,0 +1,131 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <map>
+#include <mutex>
+#include <cstdio>           // snprintf, rename
+#include "OutputCache.h"
+using namespace std;
+
+OutputCache::OutputCache(string dir, string version, string optionsDescription)
+{
+	directory = dir;
+	currentVersion = version;
+	currentOptionsHash = hashToString(fnv1a(optionsDescription));
+}
+
+///////////////////////////////////////
+// ACCESSORS
+///////////////////////////////////////
+
+bool OutputCache::IsUpToDate (int seed) {
+	string expectedHash;
+	{
+		lock_guard<mutex> guard(manifestLock);
+		map<int, Entry>::iterator found = entries.find(seed);
+		if (found == entries.end()) { return false; }
+		if (found->second.version != currentVersion || found->second.optionsHash != currentOptionsHash) { return false; }
+		expectedHash = found->second.contentHash;
+	}
+
+	// the file may have been edited, truncated or deleted since
+	ifstream inFile(GetFileName(seed).c_str(), ios::binary);
+	if (inFile.fail()) { return false; }
+	ostringstream contents;
+	contents << inFile.rdbuf();
+
+	return hashToString(fnv1a(contents.str())) == expectedHash;
+}
+
+string OutputCache::GetFileName (int seed) {
+	return directory + "/System_" + to_string(seed) + ".html";
+}
+
+///////////////////////////////////////
+// MUTATORS
+///////////////////////////////////////
+
+/* Load
+ * Reads the manifest, if there is one, and opens it for appending
+ * Returns false if the manifest cannot be opened for writing
+ */
+bool OutputCache::Load () {
+	string fileName = directory + "/manifest.txt";
+	ifstream inFile(fileName.c_str());
+	string line;
+	while (getline(inFile, line)) {
+		if (line.empty() || line[0] == '#') { continue; }
+
+		istringstream fields(line);
+		int seed;
+		Entry e;
+		if (fields >> seed >> e.version >> e.optionsHash >> e.contentHash) {
+			entries[seed] = e;
+		}
+	}
+	inFile.close();
+
+	manifest.open(fileName.c_str(), ios::app);
+	return !manifest.fail();
+}
+
+void OutputCache::Record (int seed, string_view contents) {
+	Entry e;
+	e.version = currentVersion;
+	e.optionsHash = currentOptionsHash;
+	e.contentHash = hashToString(fnv1a(contents));
+
+	lock_guard<mutex> guard(manifestLock);
+	entries[seed] = e;
+	manifest << seed << " " << e.version << " " << e.optionsHash << " " << e.contentHash << "\n";
+	manifest.flush();
+}
+
+/* Compact
+ * Rewrites the manifest with one line per seed
+ * The new manifest is written beside the old one and renamed over it, so a
+ * crash part way through leaves the old one intact.
+ */
+bool OutputCache::Compact () {
+	lock_guard<mutex> guard(manifestLock);
+
+	string fileName = directory + "/manifest.txt";
+	string tempName = fileName + ".tmp";
+	ofstream outFile(tempName.c_str());
+	outFile << "# GenSystem output manifest: seed version options-hash content-hash\n";
+	for (map<int, Entry>::iterator it = entries.begin(); it != entries.end(); it++) {
+		outFile << it->first << " " << it->second.version << " " << it->second.optionsHash << " " << it->second.contentHash << "\n";
+	}
+	outFile.close();
+	if (outFile.fail()) { return false; }
+
+	manifest.close();
+	bool renamed = (rename(tempName.c_str(), fileName.c_str()) == 0);
+	manifest.open(fileName.c_str(), ios::app);
+
+	return renamed;
+}
+
+///////////////////////////////////////
+// HELPERS
+///////////////////////////////////////
+
+string hashToString (unsigned long long hash) {
+	char text[17];
+	snprintf(text, sizeof(text), "%016llx", hash);
+	return text;
+}
+
+/* fnv1a
+ * 64-bit FNV-1a; only used to notice changes, not for security
+ */
+unsigned long long fnv1a (string_view data) {
+	unsigned long long hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < data.size(); i++) {
+		hash ^= (unsigned char) data[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
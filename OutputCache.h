@@ -0,0 +1,52 @@
+#ifndef OUTPUTCACHE_H
+#define OUTPUTCACHE_H
+
+#include <string>
+#include <string_view>
+#include <map>
+#include <mutex>
+#include <fstream>
+using namespace std;
+
+/* OutputCache
+ * Remembers which output files are already up to date, so that re-running a
+ * batch only regenerates what is missing or stale.
+ * The manifest (DIRECTORY/manifest.txt) holds one line per generated file:
+ *   SEED VERSION OPTIONS-HASH CONTENT-HASH
+ * A file is up to date when its seed has an entry for the current version and
+ * option set and the file on disk still hashes to the recorded content hash.
+ * Lines are appended as files are written, so an interrupted run keeps what
+ * it finished; later lines for a seed replace earlier ones.
+ */
+class OutputCache
+{
+	public:
+		// Constructors
+		OutputCache(string dir, string version, string optionsDescription);
+		// Accessors
+		bool IsUpToDate (int seed);
+		string GetFileName (int seed);
+		// Mutators
+		bool Load ();
+		void Record (int seed, string_view contents);
+		bool Compact ();
+	protected:
+	private:
+		struct Entry {
+			string version;
+			string optionsHash;
+			string contentHash;
+		};
+
+		string directory;
+		string currentVersion;
+		string currentOptionsHash;
+		mutex manifestLock;
+		map<int, Entry> entries;
+		ofstream manifest; // open for appending
+};
+
+string hashToString (unsigned long long hash);
+unsigned long long fnv1a (string_view data);
+
+#endif // OUTPUTCACHE_H
@@ -40,71 +40,78 @@ Planet::Planet(double d, double m) {
 	mass = m;
 }
 
+#ifdef COUNT_COPIES
+// the copy benchmark's counted copy; see CopyCounter.h
+Planet::Planet(const Planet & other) {
+	copyCounted(*this, other);
+}
+#endif
+
 ///////////////////////////////////////
 // ACCESSORS
 ///////////////////////////////////////
 
-double Planet::GetDistance () {
+double Planet::GetDistance () const {
 	return distance;
 }
 
-double Planet::GetEccentricity () {
+double Planet::GetEccentricity () const {
 	return eccentricity;
 }
 
-double Planet::GetMass () {
+double Planet::GetMass () const {
 	return mass;
 }
 
-double Planet::GetRadius () {
+double Planet::GetRadius () const {
 	return radius;
 }
 
-double Planet::GetDensity () {
+double Planet::GetDensity () const {
 	return density;
 }
 
-double Planet::GetGravity () {
+double Planet::GetGravity () const {
 	return gravity;
 }
 
-double Planet::GetOrbitalPeriod () {
+double Planet::GetOrbitalPeriod () const {
 	return orbitalPeriod;
 }
 
-double Planet::GetRotationPeriod () {
+double Planet::GetRotationPeriod () const {
 	return rotationPeriod;
 }
 
-double Planet::GetAxialTilt () {
+double Planet::GetAxialTilt () const {
 	return axialTilt;
 }
 
-double Planet::GetOceanPct () {
+double Planet::GetOceanPct () const {
 	return oceanPct;
 }
 
-double Planet::GetAlbedo () {
+double Planet::GetAlbedo () const {
 	return albedo;
 }
 
-double Planet::GetTemperature () {
+double Planet::GetTemperature () const {
 	return temperature;
 }
 
-PlanetClass Planet::GetPlanetClass () {
+PlanetClass Planet::GetPlanetClass () const {
 	return classOfPlanet;
 }
 
-std::array<Moon, 10> Planet::GetMoons () {
+const std::array<Moon, 10> & Planet::GetMoons () const {
 	return moons;
 }
 
-int Planet::GetNumberOfMoons () {
+int Planet::GetNumberOfMoons () const {
 	return numberOfMoons;
 }
 
-Atmosphere Planet::GetAtmosphere () {
+const Atmosphere & Planet::GetAtmosphere () const {
 	return atmosphere;
 }
 ///////////////////////////////////////
@@ -163,20 +170,30 @@ void Planet::SetPlanetClass (PlanetClass pc) {
 	classOfPlanet = pc;
 }
 
-void Planet::SetMoons (std::array<Moon, 10> mv) {
+void Planet::SetMoons (const std::array<Moon, 10> & mv) {
 	moons = mv;
 }
 
+void Planet::SetMoon (int i, const Moon & m) {
+	moons[i] = m;
+}
+
 void Planet::SetNumberOfMoons (int m) {
 	numberOfMoons = m;
 }
 
-void Planet::SetAtmosphere (Atmosphere a) {
+void Planet::SetAtmosphere (const Atmosphere & a) {
 	atmosphere = a;
 }
 ///////////////////////////////////////
 // OPERATORS
 ///////////////////////////////////////
+#ifdef COUNT_COPIES
+Planet & Planet::operator=(const Planet & rhs) {
+	copyCounted(*this, rhs);
+	return *this;
+}
+#endif
 
 /*bool operator==(Planet a, Planet b) {
 	return (a.mass == b.mass) && (a.age == b.age) && (a.metallicity == b.metallicity) && (a.temperature == b.temperature) && (a.luminosity == b.luminosity) && (a.radius == b.radius);
@@ -4,6 +4,9 @@
 #include <iostream>
 #include <array>
 #include "Moon.h"
+#ifdef COUNT_COPIES
+#include "CopyCounter.h"
+#endif
 using namespace std;
 
 enum PlanetClass {
@@ -31,6 +34,11 @@ struct Atmosphere {
 	double oxygen = 0.0;
 	double waterVapor = 0.0;
 	double pressure = 0.0;
+#ifdef COUNT_COPIES
+	Atmosphere () = default;
+	Atmosphere (const Atmosphere & other) { copyCounted(*this, other); }
+	Atmosphere & operator= (const Atmosphere & rhs) { copyCounted(*this, rhs); return *this; }
+#endif
 };
 
 class Planet
@@ -38,26 +46,28 @@ class Planet
 	public:
 		// Constructors
 		Planet();
-		//Planet(const Planet & other);
+#ifdef COUNT_COPIES
+		Planet(const Planet & other);
+#endif
 		Planet(double d);
 		Planet(double d, double m);
 		// Accessors
-		double GetDistance ();
-		double GetEccentricity ();
-		double GetMass ();
-		double GetRadius ();
-		double GetDensity ();
-		double GetGravity ();
-		double GetOrbitalPeriod ();
-		double GetRotationPeriod ();
-		double GetAxialTilt ();
-		double GetOceanPct ();
-		double GetAlbedo ();
-		double GetTemperature ();
-		PlanetClass GetPlanetClass ();
-		std::array<Moon, 10> GetMoons ();
-		int GetNumberOfMoons ();
-		Atmosphere GetAtmosphere ();
+		double GetDistance () const;
+		double GetEccentricity () const;
+		double GetMass () const;
+		double GetRadius () const;
+		double GetDensity () const;
+		double GetGravity () const;
+		double GetOrbitalPeriod () const;
+		double GetRotationPeriod () const;
+		double GetAxialTilt () const;
+		double GetOceanPct () const;
+		double GetAlbedo () const;
+		double GetTemperature () const;
+		PlanetClass GetPlanetClass () const;
+		const std::array<Moon, 10> & GetMoons () const;
+		int GetNumberOfMoons () const;
+		const Atmosphere & GetAtmosphere () const;
 		// Mutators
 		void SetDistance (double d);
 		void SetEccentricity (double e);
@@ -72,11 +82,14 @@ class Planet
 		void SetAlbedo (double ab);
 		void SetTemperature (double t);
 		void SetPlanetClass (PlanetClass pc);
-		void SetMoons (std::array<Moon, 10> mv);
+		void SetMoons (const std::array<Moon, 10> & mv);
+		void SetMoon (int i, const Moon & m);
 		void SetNumberOfMoons (int m);
-		void SetAtmosphere (Atmosphere a);
+		void SetAtmosphere (const Atmosphere & a);
 		// Operators
-		//Planet & operator=(const Planet & rhs);
+#ifdef COUNT_COPIES
+		Planet & operator=(const Planet & rhs);
+#endif
 		//bool operator==(Planet b);
 	protected:
 	private:
@@ -0,0 +1,211 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <charconv>         // to_chars
+#include "Star.h"
+#include "StarSystem.h"
+#include "Population.h"
+using namespace std;
+
+// Function declarations
+void appendNumber (string & out, double d);
+void appendStar (string & out, const Star & s);
+void appendOrbit (string & out, OverallSeparation & orbit);
+int binOf (double x, double low, double step, int bins);
+
+/* AppendPopulationHeader
+ * Stars and orbits the system does not have are left empty; hierarchy is
+ * e.g. "AB", "(AB)C", "A(BC)" or "(AB)(CD)", and the orbits are listed
+ * innermost first
+ */
+void AppendPopulationHeader (string & out) {
+	out += "seed,multiplicity,hierarchy,age,metallicity";
+	const char * names[MAX_POPULATION_STARS] = { "A", "B", "C", "D" };
+	for (int i = 0; i < MAX_POPULATION_STARS; i++) {
+		out += string(",") + names[i] + "_mass," + names[i] + "_temperature," + names[i] + "_luminosity,";
+		out += string(names[i]) + "_radius," + names[i] + "_type," + names[i] + "_class";
+	}
+	for (int i = 1; i < MAX_POPULATION_STARS; i++) {
+		out += ",orbit" + to_string(i) + "_separation,orbit" + to_string(i) + "_eccentricity";
+	}
+	out += '\n';
+}
+
+/* AppendPopulationRecord
+ * One CSV line; numbers are written in the fewest digits that read back exactly
+ */
+void AppendPopulationRecord (string & out, StarSystem & system) {
+	int multiplicity = system.GetMultiplicity();
+	out += to_string(system.seed);
+	out += ',';
+	out += to_string(multiplicity);
+	out += ',';
+	out += system.DescribeHierarchy(system.root);
+	out += ',';
+	appendNumber(out, system.stars[0].GetAge());
+	out += ',';
+	appendNumber(out, system.stars[0].GetMetallicity());
+
+	for (int i = 0; i < MAX_POPULATION_STARS; i++) {
+		if (i < multiplicity) { appendStar(out, system.stars[i]); }
+		else { out += ",,,,,,"; }
+	}
+
+	pmr::vector<int> pairs(systemMemory());
+	system.GetOrbitsInnermostFirst(system.root, pairs);
+	for (int i = 0; i < MAX_POPULATION_STARS - 1; i++) {
+		if (i < (int) pairs.size()) { appendOrbit(out, system.nodes[pairs[i]].orbit); }
+		else { out += ",,"; }
+	}
+	out += '\n';
+}
+
+///////////////////////////////////////
+// HELPERS
+///////////////////////////////////////
+
+void appendNumber (string & out, double d) {
+	char number[32];
+	to_chars_result result = to_chars(number, number + sizeof(number), d);
+	out.append(number, result.ptr);
+}
+
+// mass, temperature, luminosity, radius, type, class, each after a comma
+void appendStar (string & out, const Star & s) {
+	out += ',';
+	appendNumber(out, s.GetMass());
+	out += ',';
+	appendNumber(out, s.GetTemperature());
+	out += ',';
+	appendNumber(out, s.GetLuminosity());
+	out += ',';
+	appendNumber(out, s.GetRadius());
+	out += ',';
+	out += spectralTypeName(s.GetSpectralType());
+	out += ',';
+	out += luminosityClassName(s.GetLuminosityClass());
+}
+
+void appendOrbit (string & out, OverallSeparation & orbit) {
+	out += ',';
+	appendNumber(out, orbit.separation);
+	out += ',';
+	appendNumber(out, orbit.eccentricity);
+}
+
+/* binOf
+ * The bin of BINS equal steps from LOW holding X, clamped to the end bins
+ */
+int binOf (double x, double low, double step, int bins) {
+	double position = (x - low) / step;
+	if (!(position > 0)) { return 0; } // also catches NaN
+	if (position >= bins - 1) { return bins - 1; }
+	return (int) position;
+}
+
+///////////////////////////////////////
+// PopulationHistogram
+///////////////////////////////////////
+
+PopulationHistogram::PopulationHistogram()
+{
+	systems = 0;
+	stars = 0;
+	for (int i = 0; i <= MAX_MULTIPLICITY; i++) { byMultiplicity[i] = 0; }
+	for (int l = 0; l < LETTERS; l++) {
+		for (int s = 0; s < SUBCLASSES; s++) {
+			for (int c = 0; c < CLASSES; c++) { bySpectralType[l][s][c] = 0; }
+		}
+	}
+	for (int t = 0; t < HR_TEMPERATURE_BINS; t++) {
+		for (int b = 0; b < HR_LUMINOSITY_BINS; b++) { hrDiagram[t][b] = 0; }
+	}
+}
+
+///////////////////////////////////////
+// ACCESSORS
+///////////////////////////////////////
+
+unsigned long PopulationHistogram::GetSystemCount () { return systems; }
+unsigned long PopulationHistogram::GetStarCount () { return stars; }
+
+/* Write
+ * Three tables, each headed by a "#" line: systems by multiplicity, stars by
+ * spectral type and luminosity class, and stars by HR diagram bin (the lower
+ * edges of the bin's log temperature and log luminosity).  Empty rows are
+ * left out.
+ */
+void PopulationHistogram::Write (ostream & out) {
+	out << "# systems " << systems << ", stars " << stars << "\n";
+
+	out << "# multiplicity, systems, fraction\n";
+	for (int i = 1; i <= MAX_MULTIPLICITY; i++) {
+		if (byMultiplicity[i] == 0) { continue; }
+		out << i << " " << byMultiplicity[i] << " " << (double) byMultiplicity[i] / systems << "\n";
+	}
+
+	// hottest first, then white dwarfs
+	out << "# spectral type, luminosity class, stars, fraction\n";
+	const SpectralLetter letters[LETTERS] = { SPECTRAL_A, SPECTRAL_F, SPECTRAL_G, SPECTRAL_K, SPECTRAL_M, SPECTRAL_L, SPECTRAL_T, SPECTRAL_Y, SPECTRAL_D, SPECTRAL_NONE };
+	for (int i = 0; i < LETTERS; i++) {
+		int l = letters[i];
+		for (int s = 0; s < SUBCLASSES; s++) {
+			for (int c = 0; c < CLASSES; c++) {
+				unsigned long n = bySpectralType[l][s][c];
+				if (n == 0) { continue; }
+				SpectralType st;
+				st.letter = (SpectralLetter) l;
+				st.subclass = s;
+				out << st << " " << (LuminosityClass) c << " " << n << " " << (double) n / stars << "\n";
+			}
+		}
+	}
+
+	out << "# log temperature, log luminosity, stars\n";
+	for (int t = 0; t < HR_TEMPERATURE_BINS; t++) {
+		for (int b = 0; b < HR_LUMINOSITY_BINS; b++) {
+			if (hrDiagram[t][b] == 0) { continue; }
+			out << HR_MIN_LOG_TEMPERATURE + t * HR_LOG_TEMPERATURE_STEP << " "
+				<< HR_MIN_LOG_LUMINOSITY + b * HR_LOG_LUMINOSITY_STEP << " " << hrDiagram[t][b] << "\n";
+		}
+	}
+}
+
+///////////////////////////////////////
+// MUTATORS
+///////////////////////////////////////
+
+void PopulationHistogram::Add (StarSystem & system) {
+	systems++;
+	int multiplicity = system.GetMultiplicity();
+	if (multiplicity > MAX_MULTIPLICITY) { multiplicity = MAX_MULTIPLICITY; }
+	byMultiplicity[multiplicity]++;
+
+	for (size_t i = 0; i < system.stars.size(); i++) { AddStar(system.stars[i]); }
+}
+
+void PopulationHistogram::Merge (const PopulationHistogram & other) {
+	systems += other.systems;
+	stars += other.stars;
+	for (int i = 0; i <= MAX_MULTIPLICITY; i++) { byMultiplicity[i] += other.byMultiplicity[i]; }
+	for (int l = 0; l < LETTERS; l++) {
+		for (int s = 0; s < SUBCLASSES; s++) {
+			for (int c = 0; c < CLASSES; c++) { bySpectralType[l][s][c] += other.bySpectralType[l][s][c]; }
+		}
+	}
+	for (int t = 0; t < HR_TEMPERATURE_BINS; t++) {
+		for (int b = 0; b < HR_LUMINOSITY_BINS; b++) { hrDiagram[t][b] += other.hrDiagram[t][b]; }
+	}
+}
+
+void PopulationHistogram::AddStar (const Star & s) {
+	stars++;
+	SpectralType st = s.GetSpectralType();
+	int subclass = st.subclass < SUBCLASSES ? st.subclass : SUBCLASSES - 1;
+	bySpectralType[st.letter][subclass][s.GetLuminosityClass()]++;
+
+	int t = binOf(log10(s.GetTemperature()), HR_MIN_LOG_TEMPERATURE, HR_LOG_TEMPERATURE_STEP, HR_TEMPERATURE_BINS);
+	int b = binOf(log10(s.GetLuminosity()), HR_MIN_LOG_LUMINOSITY, HR_LOG_LUMINOSITY_STEP, HR_LUMINOSITY_BINS);
+	hrDiagram[t][b]++;
+}
@@ -0,0 +1,64 @@
+#ifndef POPULATION_H
+#define POPULATION_H
+
+#include <iostream>
+#include <string>
+#include "Star.h"
+#include "StarSystem.h"
+using namespace std;
+
+/* Population output
+ * For --stars-only runs, which only want the stellar population of many
+ * systems: either one compact CSV record per system, or histograms of the
+ * whole population.  Both take systems from GenerateStars, whose planets are
+ * left empty.
+ */
+
+// the CSV header, and one line per system after it; room for a quadruple
+const int MAX_POPULATION_STARS = 4;
+void AppendPopulationHeader (string & out);
+void AppendPopulationRecord (string & out, StarSystem & system);
+
+// HR diagram bins: log10 of temperature (K) and of luminosity (solar)
+const double HR_MIN_LOG_TEMPERATURE = 2.5;
+const double HR_LOG_TEMPERATURE_STEP = 0.05;
+const int HR_TEMPERATURE_BINS = 40;   // up to 10^4.5 K
+const double HR_MIN_LOG_LUMINOSITY = -7.0;
+const double HR_LOG_LUMINOSITY_STEP = 0.25;
+const int HR_LUMINOSITY_BINS = 44;    // up to 10^4 solar
+
+/* PopulationHistogram
+ * Counts of systems by multiplicity and of stars by spectral type and
+ * luminosity class and by HR diagram bin.  Each worker thread fills its own
+ * and they are merged at the end, so the totals do not depend on the number
+ * of threads.  Stars off the ends of the HR diagram go in the edge bins.
+ */
+class PopulationHistogram
+{
+	public:
+		// Constructors
+		PopulationHistogram();
+		// Accessors
+		unsigned long GetSystemCount ();
+		unsigned long GetStarCount ();
+		void Write (ostream & out);
+		// Mutators
+		void Add (StarSystem & system);
+		void Merge (const PopulationHistogram & other);
+	protected:
+	private:
+		void AddStar (const Star & s);
+
+		static const int LETTERS = SPECTRAL_D + 1;
+		static const int SUBCLASSES = 10;
+		static const int CLASSES = WHITE_DWARF + 1;
+		static const int MAX_MULTIPLICITY = 4;
+
+		unsigned long systems;
+		unsigned long stars;
+		unsigned long byMultiplicity[MAX_MULTIPLICITY + 1];
+		unsigned long bySpectralType[LETTERS][SUBCLASSES][CLASSES];
+		unsigned long hrDiagram[HR_TEMPERATURE_BINS][HR_LUMINOSITY_BINS];
+};
+
+#endif // POPULATION_H
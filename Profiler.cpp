@@ -0,0 +1,216 @@
+#include <iostream>
+#include <iomanip>          // setw, setprecision
+#include <mutex>
+#include <cmath>            // ldexp
+#include <string>
+#include "Profiler.h"
+using namespace std;
+
+// Function declarations
+int profileBucket (unsigned long long nanoseconds);
+double bucketMiddle (int bucket);
+double percentile (const unsigned long long * buckets, unsigned long long calls, double fraction);
+string drawPercentile (const unsigned long long * buckets, unsigned long long seeds, double fraction);
+
+/* Latency buckets
+ * Times under 16 ns get a bucket each; above that, every power of two is
+ * split into eight, so a percentile read from the buckets is within an
+ * eighth of the true time.  Everything from 2^40 ns (about 18 minutes) up
+ * shares the last bucket.
+ */
+const int PROFILE_BUCKETS = 16 + (40 - 4) * 8;
+
+// draw counts are kept exactly up to this; larger ones share the last bucket
+const int DRAW_BUCKETS = 1024;
+
+/* StageProfile
+ * One stage's calls, their total time and their latency histogram
+ */
+struct StageProfile {
+	unsigned long long calls = 0;
+	unsigned long long nanoseconds = 0;
+	unsigned long long buckets[PROFILE_BUCKETS] = {};
+
+	void Merge (const StageProfile & other) {
+		calls += other.calls;
+		nanoseconds += other.nanoseconds;
+		for (int b = 0; b < PROFILE_BUCKETS; b++) { buckets[b] += other.buckets[b]; }
+	}
+};
+
+/* DrawProfile
+ * One kind of draw count: how many seeds, their draws, how many seeds took
+ * each number of draws, and the seed that took the most
+ */
+struct DrawProfile {
+	unsigned long long seeds = 0;
+	unsigned long long draws = 0;
+	unsigned long long buckets[DRAW_BUCKETS] = {};
+	unsigned long long most = 0;
+	int mostSeed = 0;
+
+	void Merge (const DrawProfile & other) {
+		seeds += other.seeds;
+		draws += other.draws;
+		for (int b = 0; b < DRAW_BUCKETS; b++) { buckets[b] += other.buckets[b]; }
+		if (other.seeds != 0 && (seeds == other.seeds || other.most > most)) {
+			most = other.most;
+			mostSeed = other.mostSeed;
+		}
+	}
+};
+
+// what every finished thread recorded, and what guards it
+static StageProfile totals[PROFILE_STAGES];
+static DrawProfile drawTotals[DRAW_COUNTS];
+static mutex totalsLock;
+
+/* ThreadProfile
+ * This thread's tallies; added to the totals when the thread ends (or when
+ * writeProfile is called on it), so that workers and formation threads are
+ * all counted once
+ */
+struct ThreadProfile {
+	StageProfile stages[PROFILE_STAGES];
+	DrawProfile draws[DRAW_COUNTS];
+
+	void MergeIntoTotals () {
+		lock_guard<mutex> guard(totalsLock);
+		for (int s = 0; s < PROFILE_STAGES; s++) {
+			totals[s].Merge(stages[s]);
+			stages[s] = StageProfile();
+		}
+		for (int k = 0; k < DRAW_COUNTS; k++) {
+			drawTotals[k].Merge(draws[k]);
+			draws[k] = DrawProfile();
+		}
+	}
+	~ThreadProfile () { MergeIntoTotals(); }
+};
+static thread_local ThreadProfile threadProfile;
+
+static const char * stageNames[PROFILE_STAGES] = {
+	"stars", "  evolve star",
+	"disk", "outer system", "migration", "inner system", "planets", "moons",
+	"orbits", "rotation", "surface",
+	"html"
+};
+
+static const char * drawNames[DRAW_COUNTS] = { "stars", "system" };
+
+void setProfiling (bool enabled) {
+	profilingEnabled = enabled;
+}
+
+/* recordProfileTime
+ * Adds one call of STAGE, taking ELAPSED, to this thread's tallies
+ */
+void recordProfileTime (ProfileStage stage, chrono::steady_clock::duration elapsed) {
+	unsigned long long nanoseconds = chrono::duration_cast<chrono::nanoseconds>(elapsed).count();
+	StageProfile & p = threadProfile.stages[stage];
+	p.calls++;
+	p.nanoseconds += nanoseconds;
+	p.buckets[profileBucket(nanoseconds)]++;
+}
+
+/* recordProfileDraws
+ * Adds SEED's DRAWS, of KIND, to this thread's tallies
+ */
+void recordProfileDraws (DrawCount kind, int seed, unsigned long long draws) {
+	DrawProfile & p = threadProfile.draws[kind];
+	p.seeds++;
+	p.draws += draws;
+	p.buckets[draws < DRAW_BUCKETS ? draws : DRAW_BUCKETS - 1]++;
+	if (p.seeds == 1 || draws > p.most) {
+		p.most = draws;
+		p.mostSeed = seed;
+	}
+}
+
+/* writeProfile
+ * --profile: for each stage that ran, its calls, total time and median and
+ * 99th percentile time per call, over every thread, then the random draws
+ * per seed.  Call it once the workers have finished; the totals are thread
+ * time, so with -j they add up to more than the run took.
+ */
+void writeProfile (ostream & out) {
+	threadProfile.MergeIntoTotals();
+	lock_guard<mutex> guard(totalsLock);
+
+	out << "Profile:\n";
+	out << "  " << left << setw(16) << "stage" << right << setw(10) << "calls" << setw(12) << "total ms";
+	out << setw(10) << "p50 us" << setw(10) << "p99 us" << "\n";
+	out << fixed;
+	for (int s = 0; s < PROFILE_STAGES; s++) {
+		const StageProfile & p = totals[s];
+		if (p.calls == 0) { continue; }
+		out << "  " << left << setw(16) << stageNames[s] << right << setw(10) << p.calls;
+		out << setw(12) << setprecision(1) << p.nanoseconds / 1e6;
+		out << setw(10) << setprecision(2) << percentile(p.buckets, p.calls, 0.50) / 1e3;
+		out << setw(10) << percentile(p.buckets, p.calls, 0.99) / 1e3 << "\n";
+	}
+
+	bool header = false;
+	for (int k = 0; k < DRAW_COUNTS; k++) {
+		const DrawProfile & p = drawTotals[k];
+		if (p.seeds == 0) { continue; }
+		if (!header) {
+			out << "  " << left << setw(16) << "draws per seed" << right << setw(10) << "seeds" << setw(12) << "mean";
+			out << setw(10) << "p50" << setw(10) << "p99" << setw(10) << "max" << "  seed\n";
+			header = true;
+		}
+		out << "  " << left << setw(16) << drawNames[k] << right << setw(10) << p.seeds;
+		out << setw(12) << setprecision(1) << (double) p.draws / p.seeds;
+		out << setw(10) << drawPercentile(p.buckets, p.seeds, 0.50);
+		out << setw(10) << drawPercentile(p.buckets, p.seeds, 0.99);
+		out << setw(10) << p.most << "  " << p.mostSeed << "\n";
+	}
+	out.unsetf(ios::fixed);
+}
+
+///////////////////////////////////////
+// HELPERS
+///////////////////////////////////////
+
+int profileBucket (unsigned long long nanoseconds) {
+	if (nanoseconds < 16) { return (int) nanoseconds; }
+	int power = 63 - __builtin_clzll(nanoseconds);
+	if (power >= 40) { return PROFILE_BUCKETS - 1; }
+	return 16 + (power - 4) * 8 + (int) ((nanoseconds >> (power - 3)) & 7);
+}
+
+double bucketMiddle (int bucket) {
+	if (bucket < 16) { return bucket; }
+	int power = (bucket - 16) / 8 + 4;
+	int eighth = (bucket - 16) % 8;
+	return ldexp(8 + eighth + 0.5, power - 3);
+}
+
+/* percentile
+ * The middle of the bucket holding the call FRACTION of the way up
+ */
+double percentile (const unsigned long long * buckets, unsigned long long calls, double fraction) {
+	unsigned long long rank = (unsigned long long) ceil(fraction * calls);
+	if (rank < 1) { rank = 1; }
+	unsigned long long seen = 0;
+	for (int b = 0; b < PROFILE_BUCKETS; b++) {
+		seen += buckets[b];
+		if (seen >= rank) { return bucketMiddle(b); }
+	}
+	return bucketMiddle(PROFILE_BUCKETS - 1);
+}
+
+/* drawPercentile
+ * The draw count of the seed FRACTION of the way up, or "1023+" if it is
+ * past the last exact bucket
+ */
+string drawPercentile (const unsigned long long * buckets, unsigned long long seeds, double fraction) {
+	unsigned long long rank = (unsigned long long) ceil(fraction * seeds);
+	if (rank < 1) { rank = 1; }
+	unsigned long long seen = 0;
+	for (int b = 0; b < DRAW_BUCKETS - 1; b++) {
+		seen += buckets[b];
+		if (seen >= rank) { return to_string(b); }
+	}
+	return to_string(DRAW_BUCKETS - 1) + "+";
+}
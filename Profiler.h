@@ -0,0 +1,80 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include "RandomEngine.h"
+using namespace std;
+
+/* Profile stages
+ * The phases --profile times.  "evolve star" runs inside "stars" (and on
+ * its own for each --ages age); the rest follow the pipeline stages of
+ * FormationPipeline.h, then the HTML page.
+ */
+enum ProfileStage {
+	PROFILE_STARS, PROFILE_EVOLVE_STAR,
+	PROFILE_DISK, PROFILE_OUTER_SYSTEM, PROFILE_MIGRATION, PROFILE_INNER_SYSTEM, PROFILE_PLANETS, PROFILE_MOONS,
+	PROFILE_ORBITS, PROFILE_ROTATION, PROFILE_SURFACE,
+	PROFILE_HTML,
+	PROFILE_STAGES
+};
+
+/* Draw counts
+ * --profile also counts the random draws each seed took, for its stars
+ * (GenerateStars, all that --stars-only runs) and for the whole system
+ * (GenerateSystem), and names the seed that took the most.
+ */
+enum DrawCount { DRAWS_STARS, DRAWS_SYSTEM, DRAW_COUNTS };
+
+// set once by setProfiling, before any worker starts
+inline atomic<bool> profilingEnabled{false};
+
+void setProfiling (bool enabled);
+void recordProfileTime (ProfileStage stage, chrono::steady_clock::duration elapsed);
+void recordProfileDraws (DrawCount kind, int seed, unsigned long long draws);
+void writeProfile (ostream & out);
+
+/* ProfileTimer
+ * Times the scope it is declared in as one call of STAGE, if --profile is
+ * on; otherwise it costs a load and a branch.  Each thread keeps its own
+ * tallies, so timers never contend with each other.
+ */
+class ProfileTimer {
+	public:
+		explicit ProfileTimer (ProfileStage s) : stage(s), running(profilingEnabled.load(memory_order_relaxed)) {
+			if (running) { start = chrono::steady_clock::now(); }
+		}
+		~ProfileTimer () {
+			if (running) { recordProfileTime(stage, chrono::steady_clock::now() - start); }
+		}
+		ProfileTimer (const ProfileTimer &) = delete;
+		ProfileTimer & operator= (const ProfileTimer &) = delete;
+	private:
+		ProfileStage stage;
+		bool running;
+		chrono::steady_clock::time_point start;
+};
+
+/* ProfileDraws
+ * Counts the draws made on this thread in the scope it is declared in as
+ * one seed's, if --profile is on
+ */
+class ProfileDraws {
+	public:
+		ProfileDraws (DrawCount k, int s) : kind(k), seed(s), running(profilingEnabled.load(memory_order_relaxed)) {
+			start = randomDrawCount;
+		}
+		~ProfileDraws () {
+			if (running) { recordProfileDraws(kind, seed, randomDrawCount - start); }
+		}
+		ProfileDraws (const ProfileDraws &) = delete;
+		ProfileDraws & operator= (const ProfileDraws &) = delete;
+	private:
+		DrawCount kind;
+		int seed;
+		bool running;
+		unsigned long long start;
+};
+
+#endif // PROFILER_H
@@ -0,0 +1,245 @@
+#ifndef RANDOMENGINE_H
+#define RANDOMENGINE_H
+
+#include <random>
+#include <cstdint>
+#include <limits>
+using namespace std;
+
+/* RandomEngine
+ * The engine every generator function draws from, chosen at compile time:
+ *   make RNG=PHILOX   Philox4x32-10, counter-based; the default
+ *   make RNG=MINSTD   default_random_engine (minstd_rand0 in libstdc++)
+ *   make RNG=XOSHIRO  xoshiro256**
+ *   make RNG=PCG      PCG64 (XSL RR 128/64)
+ * Each engine gives every seed a different system; DescribeOptions includes
+ * the engine name, so the output cache keeps them apart.
+ *
+ * A system does not draw everything from one engine.  makeStream gives each
+ * (seed, star component, planet, stage) its own stream, so an extra draw in
+ * one stage leaves every other stage untouched and stages can be run in any
+ * order.  With Philox the tuple is simply the engine's counter; the other
+ * engines are seeded from a Philox hash of it.
+ */
+
+/* splitMix64
+ * Expands a seed into well-mixed 64-bit words for the larger engines
+ */
+inline uint64_t splitMix64 (uint64_t & state) {
+	uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+/* Xoshiro256StarStar
+ * Blackman and Vigna's xoshiro256**, a UniformRandomBitGenerator
+ */
+class Xoshiro256StarStar
+{
+	public:
+		typedef uint64_t result_type;
+
+		explicit Xoshiro256StarStar(uint64_t seed = 0) {
+			uint64_t sm = seed;
+			for (int i = 0; i < 4; i++) { s[i] = splitMix64(sm); }
+		}
+		static constexpr result_type min () { return 0; }
+		static constexpr result_type max () { return numeric_limits<uint64_t>::max(); }
+
+		result_type operator() () {
+			uint64_t result = rotl(s[1] * 5, 7) * 9;
+			uint64_t t = s[1] << 17;
+			s[2] ^= s[0];
+			s[3] ^= s[1];
+			s[1] ^= s[2];
+			s[0] ^= s[3];
+			s[2] ^= t;
+			s[3] = rotl(s[3], 45);
+			return result;
+		}
+	private:
+		static uint64_t rotl (uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+		uint64_t s[4];
+};
+
+/* Pcg64
+ * O'Neill's PCG with 128-bit state and the XSL RR output function
+ */
+class Pcg64
+{
+	public:
+		typedef uint64_t result_type;
+
+		explicit Pcg64(uint64_t seed = 0) {
+			uint64_t sm = seed;
+			uint64_t hi = splitMix64(sm);
+			uint64_t lo = splitMix64(sm);
+			increment = (((unsigned __int128) splitMix64(sm) << 64) | splitMix64(sm)) | 1;
+			state = 0;
+			(*this)();
+			state += ((unsigned __int128) hi << 64) | lo;
+			(*this)();
+		}
+		static constexpr result_type min () { return 0; }
+		static constexpr result_type max () { return numeric_limits<uint64_t>::max(); }
+
+		result_type operator() () {
+			const unsigned __int128 multiplier = ((unsigned __int128) 2549297995355413924ULL << 64) | 4865540595714422341ULL;
+			state = state * multiplier + increment;
+			uint64_t xored = (uint64_t) (state >> 64) ^ (uint64_t) state;
+			int rotation = (int) (state >> 122);
+			return (xored >> rotation) | (xored << ((-rotation) & 63));
+		}
+	private:
+		unsigned __int128 state;
+		unsigned __int128 increment;
+};
+
+/* Philox4x32
+ * Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3" (SC11),
+ * Philox4x32-10.  Each block of output is a pure function of a 64-bit key
+ * and a 128-bit counter: the low half of the counter counts blocks and the
+ * high half names the stream, so streams are independent by construction
+ * and cost nothing to set up.
+ */
+class Philox4x32
+{
+	public:
+		typedef uint64_t result_type;
+
+		explicit Philox4x32(uint64_t seed = 0, uint64_t stream = 0) {
+			key[0] = (uint32_t) seed;
+			key[1] = (uint32_t) (seed >> 32);
+			streamId = stream;
+			block = 0;
+			used = 2;
+		}
+		static constexpr result_type min () { return 0; }
+		static constexpr result_type max () { return numeric_limits<uint64_t>::max(); }
+
+		result_type operator() () {
+			if (used == 2) {
+				uint32_t counter[4] = { (uint32_t) block, (uint32_t) (block >> 32), (uint32_t) streamId, (uint32_t) (streamId >> 32) };
+				Generate(counter, key, output);
+				block++;
+				used = 0;
+			}
+			uint64_t result = output[2 * used] | ((uint64_t) output[2 * used + 1] << 32);
+			used++;
+			return result;
+		}
+
+		// ten rounds of the Philox bijection; OUT may alias COUNTER
+		static void Generate (const uint32_t counter[4], const uint32_t seedKey[2], uint32_t out[4]) {
+			uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+			uint32_t k0 = seedKey[0], k1 = seedKey[1];
+			for (int round = 0; round < 10; round++) {
+				uint64_t product0 = (uint64_t) 0xD2511F53U * c0;
+				uint64_t product1 = (uint64_t) 0xCD9E8D57U * c2;
+				uint32_t n0 = (uint32_t) (product1 >> 32) ^ c1 ^ k0;
+				uint32_t n1 = (uint32_t) product1;
+				uint32_t n2 = (uint32_t) (product0 >> 32) ^ c3 ^ k1;
+				uint32_t n3 = (uint32_t) product0;
+				c0 = n0; c1 = n1; c2 = n2; c3 = n3;
+				k0 += 0x9E3779B9U;
+				k1 += 0xBB67AE85U;
+			}
+			out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+		}
+	private:
+		uint32_t key[2];
+		uint64_t streamId;
+		uint64_t block; // next block to generate
+		uint32_t output[4];
+		int used; // 64-bit halves of output already returned
+};
+
+#if defined(RANDOM_ENGINE_MINSTD)
+typedef default_random_engine BaseRandomEngine;
+#define RANDOM_ENGINE_NAME "minstd"
+#elif defined(RANDOM_ENGINE_XOSHIRO)
+typedef Xoshiro256StarStar BaseRandomEngine;
+#define RANDOM_ENGINE_NAME "xoshiro256**"
+#elif defined(RANDOM_ENGINE_PCG)
+typedef Pcg64 BaseRandomEngine;
+#define RANDOM_ENGINE_NAME "pcg64"
+#else
+typedef Philox4x32 BaseRandomEngine;
+#define RANDOM_ENGINE_NAME "philox4x32-10"
+#endif
+
+// draws made on this thread, and by the formation workers for its systems
+inline thread_local unsigned long long randomDrawCount = 0;
+
+/* CountingEngine
+ * Wraps an engine and counts its draws in randomDrawCount, at the cost of
+ * an increment per draw.  The difference across a call is the draws it
+ * took; --profile and the /stats endpoint report them per seed, since a
+ * seed that needs many more draws than most is one that is slow to
+ * generate.
+ */
+template <class Engine>
+class CountingEngine : public Engine
+{
+	public:
+		typedef typename Engine::result_type result_type;
+
+		template <class... Args>
+		explicit CountingEngine(Args... args) : Engine(args...) {}
+
+		result_type operator() () {
+			randomDrawCount++;
+			return Engine::operator()();
+		}
+};
+
+typedef CountingEngine<BaseRandomEngine> RandomEngine;
+
+/* RandomStage
+ * The independent streams of one star's system, for makeStream
+ * Values are part of every stream's identity, so only ever add to the end.
+ */
+enum RandomStage {
+	STAGE_PRIMARY,          // primary mass and whether there are companions
+	STAGE_COMPANIONS,       // multiplicity, mass ratios and separations
+	STAGE_AGE,              // system age and metallicity
+	STAGE_EVOLUTION,        // one per star component
+	STAGE_DISK,             // disk mass and migration factors
+	STAGE_OUTER_SYSTEM,     // one per outer formation slot (5-11)
+	STAGE_DYNAMICS,         // Grand Tack and Nice event
+	STAGE_OUTER_PLACEMENT,
+	STAGE_INNER_SYSTEM,     // one per inner formation slot (0-4)
+	STAGE_INNER_MIGRATION,
+	STAGE_INNER_PLACEMENT,
+	STAGE_ECCENTRICITY,     // this and the rest: one per final planet
+	STAGE_DENSITY,
+	STAGE_MOONS,
+	STAGE_ROTATION,
+	STAGE_SURFACE
+};
+
+// Philox takes the stream as its counter; any other engine is seeded from a hash of it
+template <class Engine>
+Engine streamEngine (uint32_t seed, uint64_t streamId, true_type) {
+	return Engine(seed, streamId);
+}
+
+template <class Engine>
+Engine streamEngine (uint32_t seed, uint64_t streamId, false_type) {
+	Philox4x32 hash(seed, streamId);
+	return Engine((typename Engine::result_type) hash());
+}
+
+/* makeStream
+ * The engine for one (seed, component, planet, stage); COMPONENT and PLANET
+ * are -1 when the stage is not about a particular star or planet
+ */
+inline RandomEngine makeStream (int seed, int component, int planet, RandomStage stage) {
+	uint64_t streamId = (uint64_t) (uint16_t) stage
+		| ((uint64_t) (uint16_t) (planet + 1) << 16)
+		| ((uint64_t) (uint16_t) (component + 1) << 32);
+	return streamEngine<RandomEngine>((uint32_t) seed, streamId, is_same<BaseRandomEngine, Philox4x32>());
+}
+
+#endif // RANDOMENGINE_H
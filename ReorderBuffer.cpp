@@ -0,0 +1,36 @@
+#include <iostream>
+#include <string>
+#include <map>
+#include <mutex>
+#include "ReorderBuffer.h"
+using namespace std;
+
+ReorderBuffer::ReorderBuffer(ostream & o) : out(o)
+{
+	nextIndex = 0;
+}
+
+///////////////////////////////////////
+// MUTATORS
+///////////////////////////////////////
+
+void ReorderBuffer::Submit (size_t index, string text) {
+	lock_guard<mutex> guard(bufferLock);
+
+	if (index != nextIndex) {
+		pending[index] = std::move(text);
+		return;
+	}
+
+	out << text;
+	nextIndex++;
+
+	// release everything that was waiting on this item
+	map<size_t, string>::iterator it = pending.begin();
+	while (it != pending.end() && it->first == nextIndex) {
+		out << it->second;
+		nextIndex++;
+		it = pending.erase(it);
+	}
+	out.flush();
+}
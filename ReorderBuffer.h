@@ -0,0 +1,29 @@
+#ifndef REORDERBUFFER_H
+#define REORDERBUFFER_H
+
+#include <iostream>
+#include <string>
+#include <map>
+#include <mutex>
+using namespace std;
+
+/* ReorderBuffer
+ * Collects the text produced for each item of a batch, which workers may
+ * finish in any order, and writes it to the output stream in item order.
+ */
+class ReorderBuffer
+{
+	public:
+		// Constructors
+		ReorderBuffer(ostream & o);
+		// Mutators
+		void Submit (size_t index, string text);
+	protected:
+	private:
+		ostream & out;
+		mutex bufferLock;
+		size_t nextIndex; // next item to be written
+		map<size_t, string> pending; // finished items waiting for earlier ones
+};
+
+#endif // REORDERBUFFER_H
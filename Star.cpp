@@ -7,7 +7,14 @@ using namespace std;
 
 Star::Star()
 {
-	//ctor
+	mass = 0.0;
+	initialMass = 0.0;
+	age = 0.0;
+	metallicity = 0.0;
+	temperature = 0.0;
+	luminosity = 0.0;
+	radius = 0.0;
+	luminosityClass = LUMINOSITY_NONE;
 }
 
 /*Star::Star(const Star& other) {
@@ -22,42 +29,60 @@ Star::Star()
 //alternate constructor
 Star::Star(double m)
 {
-    mass = m;
+	mass = m;
+	initialMass = m;
+	age = 0.0;
+	metallicity = 0.0;
+	temperature = 0.0;
+	luminosity = 0.0;
+	radius = 0.0;
+	luminosityClass = LUMINOSITY_NONE;
+}
+
+#ifdef COUNT_COPIES
+// the copy benchmark's counted copy; see CopyCounter.h
+Star::Star(const Star & other) {
+	copyCounted(*this, other);
 }
+#endif
 
 ///////////////////////////////////////
 // ACCESSORS
 ///////////////////////////////////////
 
-double Star::GetMass () {
+double Star::GetMass () const {
 	return mass;
 }
 
-double Star::GetAge () {
+double Star::GetInitialMass () const {
+	return initialMass;
+}
+
+double Star::GetAge () const {
 	return age;
 }
 
-double Star::GetMetallicity () {
+double Star::GetMetallicity () const {
 	return metallicity;
 }
 
-double Star::GetTemperature () {
+double Star::GetTemperature () const {
 	return temperature;
 }
 
-double Star::GetLuminosity () {
+double Star::GetLuminosity () const {
 	return luminosity;
 }
 
-double Star::GetRadius () {
+double Star::GetRadius () const {
 	return radius;
 }
 
-string Star::GetSpectralType () {
+SpectralType Star::GetSpectralType () const {
 	return spectralType;
 }
 
-string Star::GetLuminosityClass () {
+LuminosityClass Star::GetLuminosityClass () const {
 	return luminosityClass;
 }
 /*char Star::GetSpectralClass () const
@@ -128,15 +153,21 @@ void Star::SetRadius (double r) {
 	radius = r;
 }
 
-void Star::SetSpectralType (string st) {
+void Star::SetSpectralType (SpectralType st) {
 	spectralType = st;
 }
-void Star::SetLuminosityClass (string lc) {
+void Star::SetLuminosityClass (LuminosityClass lc) {
 	luminosityClass = lc;
 }
 ///////////////////////////////////////
 // OPERATORS
 ///////////////////////////////////////
+#ifdef COUNT_COPIES
+Star & Star::operator=(const Star & rhs) {
+	copyCounted(*this, rhs);
+	return *this;
+}
+#endif
 /*Star & Star::operator=(const Star & rhs) {
 	if (this == &rhs) return *this; // handle self assignment
 	//assignment operator
@@ -155,3 +186,40 @@ ostream& operator<<(ostream & outs, const Star & star)
     outs << star.GetSubClass();
     outs << star.GetLuminosityClass();
 }*/
+
+///////////////////////////////////////
+// OUTPUT
+///////////////////////////////////////
+
+// indexed by SpectralLetter
+const char SPECTRAL_LETTERS[] = "YTLMKGFAD";
+
+string spectralTypeName (SpectralType st) {
+	string name;
+	if (st.letter == SPECTRAL_NONE) { return name; }
+	name += SPECTRAL_LETTERS[st.letter - SPECTRAL_Y];
+	if (st.letter != SPECTRAL_D) { name += (char) ('0' + st.subclass); }
+	return name;
+}
+
+const char * luminosityClassName (LuminosityClass lc) {
+	switch (lc) {
+		case BRIGHT_GIANT: return "II";
+		case GIANT: return "III";
+		case SUBGIANT: return "IV";
+		case MAIN_SEQUENCE: return "V";
+		case WHITE_DWARF: return "WD";
+		default: return "";
+	}
+}
+
+ostream & operator<< (ostream & outs, SpectralType st) {
+	if (st.letter == SPECTRAL_NONE) { return outs; }
+	outs << SPECTRAL_LETTERS[st.letter - SPECTRAL_Y];
+	if (st.letter != SPECTRAL_D) { outs << (char) ('0' + st.subclass); }
+	return outs;
+}
+
+ostream & operator<< (ostream & outs, LuminosityClass lc) {
+	return outs << luminosityClassName(lc);
+}
@@ -4,24 +4,60 @@
 #include <vector>
 #include <iostream>
 #include "Planet.h"
+#ifdef COUNT_COPIES
+#include "CopyCounter.h"
+#endif
 using namespace std;
 
+enum SpectralLetter : unsigned char {
+	SPECTRAL_NONE,
+	SPECTRAL_Y,
+	SPECTRAL_T,
+	SPECTRAL_L,
+	SPECTRAL_M,
+	SPECTRAL_K,
+	SPECTRAL_G,
+	SPECTRAL_F,
+	SPECTRAL_A,
+	SPECTRAL_D      // white dwarf; no subclass
+};
+
+/* SpectralType
+ * Letter and subclass, e.g. G2; two bytes in place of a string
+ */
+struct SpectralType {
+	SpectralLetter letter = SPECTRAL_NONE;
+	unsigned char subclass = 0;
+};
+
+enum LuminosityClass : unsigned char {
+	LUMINOSITY_NONE,
+	BRIGHT_GIANT,   // II
+	GIANT,          // III
+	SUBGIANT,       // IV
+	MAIN_SEQUENCE,  // V
+	WHITE_DWARF     // WD
+};
+
 class Star
 {
 	public:
 		// Constructors
 		Star();
 		Star(double m);
-		//Star(const Star & other);
+#ifdef COUNT_COPIES
+		Star(const Star & other);
+#endif
 		// Accessors
-		double GetMass ();
-		double GetAge ();
-		double GetMetallicity ();
-		double GetTemperature ();
-		double GetLuminosity ();
-		double GetRadius ();
-		string GetSpectralType ();
-		string GetLuminosityClass ();
+		double GetMass () const;
+		double GetInitialMass () const;
+		double GetAge () const;
+		double GetMetallicity () const;
+		double GetTemperature () const;
+		double GetLuminosity () const;
+		double GetRadius () const;
+		SpectralType GetSpectralType () const;
+		LuminosityClass GetLuminosityClass () const;
 		// Mutators
 		void SetMass (double m);
 		void SetAge (double a);
@@ -29,21 +65,30 @@ class Star
 		void SetTemperature (double t);
 		void SetLuminosity (double l);
 		void SetRadius (double r);
-		void SetSpectralType (string st);
-		void SetLuminosityClass (string lc);
+		void SetSpectralType (SpectralType st);
+		void SetLuminosityClass (LuminosityClass lc);
 		// Operators
-		//Star & operator=(const Star & rhs);
+#ifdef COUNT_COPIES
+		Star & operator=(const Star & rhs);
+#endif
 		//bool operator==(Star a, Star b)
 	protected:
 	private:
 		double mass;
+		double initialMass; // at birth; evolveStar works from this, since white dwarfs lose mass
 		double age;
 		double metallicity;
 		double temperature;
 		double luminosity;
 		double radius;
-		string spectralType;
-		string luminosityClass;
+		SpectralType spectralType;
+		LuminosityClass luminosityClass;
 };
 
+// names for output, e.g. "G2" and "V"
+string spectralTypeName (SpectralType st);
+const char * luminosityClassName (LuminosityClass lc);
+ostream & operator<< (ostream & outs, SpectralType st);
+ostream & operator<< (ostream & outs, LuminosityClass lc);
+
 #endif // STAR_H
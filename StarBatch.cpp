@@ -0,0 +1,96 @@
+#include <vector>
+#include <cmath>
+#include "StarBatch.h"
+#include "Generator.h"
+#include "Distributions.h"
+using namespace std;
+
+// Function declarations
+const BatchKernels & chooseBatchKernels ();
+void scalarInitialMasses (const double * uniforms, double * mass, size_t n);
+void scalarMainSequence (const double * mass, const double * age, double * luminosity, double * temperature, double * radius, unsigned char * onMainSequence, size_t n);
+
+const BatchKernels SCALAR_KERNELS = { "scalar", scalarInitialMasses, scalarMainSequence };
+
+void StarBatch::Resize (size_t n) {
+	mass.resize(n);
+	age.resize(n);
+	luminosity.resize(n);
+	temperature.resize(n);
+	radius.resize(n);
+	onMainSequence.resize(n);
+}
+
+/* getBatchKernels
+ * The vector levels need both the compiler flags at build time and the
+ * instructions on the CPU running it
+ */
+const BatchKernels * getBatchKernels (BatchKernelLevel level) {
+	switch (level) {
+		case BATCH_SCALAR:
+			return &SCALAR_KERNELS;
+#if defined(__x86_64__) || defined(__i386__)
+		case BATCH_AVX2:
+			if (!__builtin_cpu_supports("avx2")) { return nullptr; }
+			return avx2BatchKernels();
+		case BATCH_AVX512:
+			if (!__builtin_cpu_supports("avx512f")) { return nullptr; }
+			return avx512BatchKernels();
+#endif
+		default:
+			return nullptr;
+	}
+}
+
+const BatchKernels & chooseBatchKernels () {
+	const BatchKernels * best = getBatchKernels(BATCH_AVX512);
+	if (best == nullptr) { best = getBatchKernels(BATCH_AVX2); }
+	if (best == nullptr) { best = getBatchKernels(BATCH_SCALAR); }
+	return *best;
+}
+
+const BatchKernels & bestBatchKernels () {
+	static const BatchKernels & best = chooseBatchKernels();
+	return best;
+}
+
+/* sampleInitialMasses
+ * Fills STARS.mass with initialMassFunction masses.  The draws are made in
+ * the order that one initialMassFunction call per star would make them, so
+ * an engine in the same state gives the same masses, to BATCH_TOLERANCE.
+ */
+void sampleInitialMasses (RandomEngine & e, StarBatch & stars) {
+	vector<double> uniforms(2 * stars.Size());
+	UniformRealDistribution randU(0, 1);
+	randU.Fill(e, uniforms.data(), uniforms.size());
+	bestBatchKernels().initialMasses(uniforms.data(), stars.mass.data(), stars.Size());
+}
+
+/* evolveMainSequence
+ * Sets the luminosity, temperature and radius of every main-sequence star
+ * from its mass and age.  Stars left with onMainSequence 0 still need
+ * evolveStar.
+ */
+void evolveMainSequence (StarBatch & stars) {
+	bestBatchKernels().mainSequence(stars.mass.data(), stars.age.data(), stars.luminosity.data(), stars.temperature.data(), stars.radius.data(), stars.onMainSequence.data(), stars.Size());
+}
+
+///////////////////////////////////////
+// HELPERS
+///////////////////////////////////////
+
+void scalarInitialMasses (const double * uniforms, double * mass, size_t n) {
+	for (size_t i = 0; i < n; i++) {
+		mass[i] = kroupaMass(uniforms[2 * i], uniforms[2 * i + 1]);
+	}
+}
+
+void scalarMainSequence (const double * mass, const double * age, double * luminosity, double * temperature, double * radius, unsigned char * onMainSequence, size_t n) {
+	for (size_t i = 0; i < n; i++) {
+		double lifespan = getStellarLifespan(mass[i]);
+		luminosity[i] = getInitialLuminosity(mass[i]) * pow(2.2, age[i] / lifespan);
+		temperature[i] = getInitialTemperature(mass[i]);
+		radius[i] = getStellarRadius(luminosity[i], temperature[i]);
+		onMainSequence[i] = mass[i] >= 0.08 && age[i] <= lifespan;
+	}
+}
@@ -0,0 +1,72 @@
+#ifndef STARBATCH_H
+#define STARBATCH_H
+
+#include <vector>
+#include <cstddef>
+#include "RandomEngine.h"
+using namespace std;
+
+/* StarBatch
+ * Many stars at once, one array per quantity, for population work: the
+ * batch kernels below run over these arrays several stars per instruction.
+ * They are library API for programs built on libgensystem, and only the
+ * benchmarks call them: GenSystem's own --stars-only makes each seed's stars
+ * with GenerateStars, so that they are the stars of that seed's full
+ * system, which masses drawn for a whole batch from one engine are not.
+ */
+struct StarBatch {
+	vector<double> mass;
+	vector<double> age;
+	vector<double> luminosity;
+	vector<double> temperature;
+	vector<double> radius;
+	vector<unsigned char> onMainSequence; // set by evolveMainSequence
+
+	void Resize (size_t n);
+	size_t Size () const { return mass.size(); }
+};
+
+/* BatchKernels
+ * One implementation of the batch math:
+ *   initialMasses  Kroupa masses, as initialMassFunction gives them, from
+ *                  two uniforms [0, 1) a star: basis, then second
+ *   mainSequence   luminosity, temperature and radius of main-sequence
+ *                  stars, as evolveStar gives them, from mass and age;
+ *                  onMainSequence is 0 for brown dwarfs and for stars past
+ *                  their lifespan, whose other outputs are then meaningless
+ *
+ * The scalar kernels evaluate getInitialLuminosity, getStellarLifespan,
+ * getInitialTemperature and getStellarRadius with the C library's pow, exp
+ * and log.  The AVX2 and AVX-512 kernels evaluate the same formulas with
+ * their own vector exp and log, and agree with the scalar kernels to a
+ * relative 1e-13 (measured: a few parts in 1e15).  evolveStar itself reads
+ * the evolution grid, which agrees with both to 1e-4.
+ */
+struct BatchKernels {
+	const char * name;
+	void (*initialMasses) (const double * uniforms, double * mass, size_t n);
+	void (*mainSequence) (const double * mass, const double * age, double * luminosity, double * temperature, double * radius, unsigned char * onMainSequence, size_t n);
+};
+
+enum BatchKernelLevel {
+	BATCH_SCALAR,
+	BATCH_AVX2,
+	BATCH_AVX512
+};
+
+const double BATCH_TOLERANCE = 1e-13;
+
+// nullptr if the level was not compiled in or this CPU lacks it
+const BatchKernels * getBatchKernels (BatchKernelLevel level);
+// the widest level this CPU runs, chosen once per process
+const BatchKernels & bestBatchKernels ();
+
+void sampleInitialMasses (RandomEngine & e, StarBatch & stars);
+void evolveMainSequence (StarBatch & stars);
+
+// defined by StarBatchAvx2.cpp and StarBatchAvx512.cpp; nullptr when built
+// without the instruction set
+const BatchKernels * avx2BatchKernels ();
+const BatchKernels * avx512BatchKernels ();
+
+#endif // STARBATCH_H
@@ -0,0 +1,31 @@
+#include <cstddef>
+#include "StarBatch.h"
+#include "StarKernels.h"
+using namespace std;
+
+/* StarBatchAvx2
+ * The batch kernels four doubles at a time; built with -mavx2 (see the
+ * Makefile), and empty otherwise
+ */
+#ifdef __AVX2__
+typedef double DoubleX4 __attribute__((vector_size(32)));
+typedef long long LongX4 __attribute__((vector_size(32)));
+
+static void avx2InitialMasses (const double * uniforms, double * mass, size_t n) {
+	batchInitialMasses<DoubleX4, LongX4, 4>(uniforms, mass, n);
+}
+
+static void avx2MainSequence (const double * mass, const double * age, double * luminosity, double * temperature, double * radius, unsigned char * onMainSequence, size_t n) {
+	batchMainSequence<DoubleX4, LongX4, 4>(mass, age, luminosity, temperature, radius, onMainSequence, n);
+}
+
+static const BatchKernels AVX2_KERNELS = { "avx2", avx2InitialMasses, avx2MainSequence };
+
+const BatchKernels * avx2BatchKernels () {
+	return &AVX2_KERNELS;
+}
+#else
+const BatchKernels * avx2BatchKernels () {
+	return nullptr;
+}
+#endif
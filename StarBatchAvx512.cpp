@@ -0,0 +1,31 @@
+#include <cstddef>
+#include "StarBatch.h"
+#include "StarKernels.h"
+using namespace std;
+
+/* StarBatchAvx512
+ * The batch kernels eight doubles at a time; built with -mavx512f (see
+ * the Makefile), and empty otherwise
+ */
+#ifdef __AVX512F__
+typedef double DoubleX8 __attribute__((vector_size(64)));
+typedef long long LongX8 __attribute__((vector_size(64)));
+
+static void avx512InitialMasses (const double * uniforms, double * mass, size_t n) {
+	batchInitialMasses<DoubleX8, LongX8, 8>(uniforms, mass, n);
+}
+
+static void avx512MainSequence (const double * mass, const double * age, double * luminosity, double * temperature, double * radius, unsigned char * onMainSequence, size_t n) {
+	batchMainSequence<DoubleX8, LongX8, 8>(mass, age, luminosity, temperature, radius, onMainSequence, n);
+}
+
+static const BatchKernels AVX512_KERNELS = { "avx512", avx512InitialMasses, avx512MainSequence };
+
+const BatchKernels * avx512BatchKernels () {
+	return &AVX512_KERNELS;
+}
+#else
+const BatchKernels * avx512BatchKernels () {
+	return nullptr;
+}
+#endif
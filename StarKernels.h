@@ -0,0 +1,197 @@
+#ifndef STARKERNELS_H
+#define STARKERNELS_H
+
+#include <cstring>          // memcpy
+#include <cstddef>
+
+/* StarKernels
+ * The vector batch kernels, written once over GCC vector types and compiled
+ * by StarBatchAvx2.cpp (4 doubles a vector) and StarBatchAvx512.cpp (8), each
+ * with its own instruction set.  Everything here is static, so the two
+ * copies never meet at link time.
+ *
+ * V is a vector of W doubles and VI the vector of W 64-bit integers of the
+ * same size; comparisons give VI masks, and casts between the two
+ * reinterpret the bits.  Only +, -, *, / and bit operations are used; exp
+ * and log are computed here, to within a few units in the last place.
+ */
+
+// 1.5 * 2^52: adding it rounds a double to an integer held in the low bits
+static const double ROUNDING_BIAS = 6755399441055744.0;
+
+// every lane set to C
+template <class V, class S>
+static inline V splat (S c) {
+	V v = {};
+	return v + c;
+}
+
+/* vectorExp
+ * 2^n * exp(r), n = round(x / ln 2), |r| <= ln 2 / 2, exp(r) by its Taylor
+ * series to r^13.  X must lie within +-708.
+ */
+template <class V, class VI>
+static inline V vectorExp (V x) {
+	const double ln2High = 0.693147180369123816490;
+	const double ln2Low = 1.90821492927058770002e-10;
+	V t = x * 1.44269504088896340736 + ROUNDING_BIAS;
+	V n = t - ROUNDING_BIAS;
+	V r = (x - n * ln2High) - n * ln2Low;
+
+	V p = r * (1.0 / 6227020800.0) + 1.0 / 479001600.0;
+	p = p * r + 1.0 / 39916800.0;
+	p = p * r + 1.0 / 3628800.0;
+	p = p * r + 1.0 / 362880.0;
+	p = p * r + 1.0 / 40320.0;
+	p = p * r + 1.0 / 5040.0;
+	p = p * r + 1.0 / 720.0;
+	p = p * r + 1.0 / 120.0;
+	p = p * r + 1.0 / 24.0;
+	p = p * r + 1.0 / 6.0;
+	p = p * r + 0.5;
+	p = p * r + 1.0;
+	p = p * r + 1.0;
+
+	// the low bits of t hold n; move them into the exponent field
+	VI scale = (((VI) t - (VI) splat<V>(ROUNDING_BIAS)) + 1023) << 52;
+	return p * (V) scale;
+}
+
+/* vectorLog
+ * x = m * 2^e with m in [sqrt(1/2), sqrt(2)); log m = 2 atanh(f),
+ * f = (m - 1) / (m + 1), by its series to f^21.  X must be positive, finite
+ * and normal.
+ */
+template <class V, class VI>
+static inline V vectorLog (V x) {
+	const VI mantissaBits = splat<VI>(0x000fffffffffffffLL);
+	const VI oneBits = (VI) splat<V>(1.0);
+	VI bits = (VI) x;
+	VI e = ((bits >> 52) & 0x7ff) - 1023;
+	V m = (V) ((bits & mantissaBits) | oneBits);
+	VI high = m > 1.41421356237309504880;
+	m = high ? m * 0.5 : m;
+	e = e - high; // true is -1
+
+	// e is small, so it converts through the rounding bias
+	V exponent = (V) (e + (VI) splat<V>(ROUNDING_BIAS)) - ROUNDING_BIAS;
+
+	V f = (m - 1.0) / (m + 1.0);
+	V f2 = f * f;
+	V s = f2 * (1.0 / 21.0) + 1.0 / 19.0;
+	s = s * f2 + 1.0 / 17.0;
+	s = s * f2 + 1.0 / 15.0;
+	s = s * f2 + 1.0 / 13.0;
+	s = s * f2 + 1.0 / 11.0;
+	s = s * f2 + 1.0 / 9.0;
+	s = s * f2 + 1.0 / 7.0;
+	s = s * f2 + 1.0 / 5.0;
+	s = s * f2 + 1.0 / 3.0;
+	s = s * f2 + 1.0;
+
+	return exponent * 0.693147180559945309417 + 2.0 * f * s;
+}
+
+/* batchInitialMasses
+ * initialMassFunction: basis = 4.7511 u0 picks the segment of the Kroupa
+ * CDF, second = low + u1 (high - low) within it, mass = second^(1 / power)
+ */
+template <class V, class VI, int W>
+static void batchInitialMasses (const double * uniforms, double * mass, size_t n) {
+	// the uniforms come in pairs, so lanes 0, 2, 4... of two vectors are bases
+	VI evens;
+	VI odds;
+	for (int j = 0; j < W; j++) {
+		evens[j] = 2 * j;
+		odds[j] = 2 * j + 1;
+	}
+
+	for (size_t i = 0; i < n; i += W) {
+		size_t lanes = (n - i < W) ? n - i : W;
+		double padded[2 * W] = {};
+		const double * in = uniforms + 2 * i;
+		if (lanes < W) {
+			memcpy(padded, in, 2 * lanes * sizeof(double));
+			in = padded;
+		}
+		V first;
+		V next;
+		memcpy(&first, in, sizeof(V));
+		memcpy(&next, in + W, sizeof(V));
+		V basis = __builtin_shuffle(first, next, evens) * 4.7511;
+		V second = __builtin_shuffle(first, next, odds);
+
+		VI lowest = basis <= 0.1869;
+		VI middle = basis <= 3.1944;
+		VI third = basis <= 4.3192;
+		V low = lowest ? splat<V>(2.1334) : (middle ? splat<V>(2.4623) : (third ? splat<V>(1.0) : splat<V>(0.1219)));
+		V high = lowest ? splat<V>(3.9811) : (middle ? splat<V>(26.6675) : (third ? splat<V>(4.9246) : splat<V>(1.0)));
+		V power = lowest ? splat<V>(1 / -0.3) : (middle ? splat<V>(1 / -1.3) : (third ? splat<V>(1 / -2.3) : splat<V>(1 / -2.7)));
+
+		second = low + second * (high - low);
+		V result = vectorExp<V, VI>(vectorLog<V, VI>(second) * power);
+		memcpy(mass + i, &result, lanes * sizeof(double));
+	}
+}
+
+/* batchMainSequence
+ * evolveStar's main sequence, with its regressions written over log mass:
+ *   L0 = 0.2106 M^2.3357 below 0.5, 0.7329 M^4.6128 above
+ *   lifespan = 43 M^-1.3 below 0.43, 10 M^-3 below 2, 7.1 M^-2.5 above
+ *   L = L0 * 2.2^(age / lifespan)
+ *   T = 4335.95 + 684.72 ln M below 0.5, 7007.56 / (1 + 4.2427 e^(-2.914 M))
+ *       below 1.3, 2857.576 M + 2537.984 above
+ *   R = sqrt(L) / (T / 5772)^2
+ */
+template <class V, class VI, int W>
+static void batchMainSequence (const double * mass, const double * age, double * luminosity, double * temperature, double * radius, unsigned char * onMainSequence, size_t n) {
+	for (size_t i = 0; i < n; i += W) {
+		size_t lanes = (n - i < W) ? n - i : W;
+		V m;
+		V a;
+		if (lanes == W) {
+			memcpy(&m, mass + i, sizeof(V));
+			memcpy(&a, age + i, sizeof(V));
+		}
+		else { // pad the last vector with a harmless star
+			m = splat<V>(1.0);
+			a = splat<V>(0.0);
+			for (size_t j = 0; j < lanes; j++) {
+				m[j] = mass[i + j];
+				a[j] = age[i + j];
+			}
+		}
+		V logMass = vectorLog<V, VI>(m);
+
+		VI small = m < 0.5;
+		V logInitialLuminosity = small
+			? -1.557794679282262 + 2.3357 * logMass  // ln 0.2106
+			: -0.3107460120503326 + 4.6128 * logMass; // ln 0.7329
+
+		VI lowMass = m < 0.43;
+		VI midMass = m < 2.0;
+		V lifespanScale = lowMass ? splat<V>(43.0) : (midMass ? splat<V>(10.0) : splat<V>(7.1));
+		V lifespanPower = lowMass ? splat<V>(-1.3) : (midMass ? splat<V>(-3.0) : splat<V>(-2.5));
+		V lifespan = lifespanScale * vectorExp<V, VI>(lifespanPower * logMass);
+
+		V logLum = logInitialLuminosity + 0.7884573603642703 * a / lifespan; // ln 2.2
+		V lum = vectorExp<V, VI>(logLum);
+
+		VI warm = m < 1.3;
+		V logistic = 7007.56 / (1.0 + 4.2427 * vectorExp<V, VI>(-2.914 * m));
+		V temp = small ? 4335.95 + 684.72 * logMass : (warm ? logistic : 2857.576 * m + 2537.984);
+
+		V scaledTemp = temp / 5772.0;
+		V rad = vectorExp<V, VI>(0.5 * logLum) / (scaledTemp * scaledTemp);
+		VI onMain = (m >= 0.08) & (a <= lifespan);
+
+		memcpy(luminosity + i, &lum, lanes * sizeof(double));
+		memcpy(temperature + i, &temp, lanes * sizeof(double));
+		memcpy(radius + i, &rad, lanes * sizeof(double));
+		for (size_t j = 0; j < lanes; j++) {
+			onMainSequence[i + j] = onMain[j] != 0;
+		}
+	}
+}
+
+#endif // STARKERNELS_H
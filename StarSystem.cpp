@@ -0,0 +1,81 @@
+#include <vector>
+#include <string>
+#include "Star.h"
+#include "StarSystem.h"
+using namespace std;
+
+///////////////////////////////////////
+// ACCESSORS
+///////////////////////////////////////
+
+/* GetNodeMass
+ * The mass of every star in the node
+ */
+double StarSystem::GetNodeMass (int node) {
+	StellarNode & n = nodes[node];
+	if (n.star >= 0) { return stars[n.star].GetMass(); }
+	return GetNodeMass(n.primary) + GetNodeMass(n.companion);
+}
+
+/* DescribeHierarchy
+ * The node in brackets notation, e.g. "A", "AB", "(AB)C" or "(AB)(CD)"
+ */
+string StarSystem::DescribeHierarchy (int node) {
+	StellarNode & n = nodes[node];
+	if (n.star >= 0) { return n.name; }
+
+	string primary = DescribeHierarchy(n.primary);
+	string companion = DescribeHierarchy(n.companion);
+	if (nodes[n.primary].star < 0) { primary = "(" + primary + ")"; }
+	if (nodes[n.companion].star < 0) { companion = "(" + companion + ")"; }
+	return primary + companion;
+}
+
+/* GetOrbitsInnermostFirst
+ * Appends the pairs within the node to PAIRS, each after the pairs inside it
+ */
+void StarSystem::GetOrbitsInnermostFirst (int node, pmr::vector<int> & pairs) {
+	StellarNode & n = nodes[node];
+	if (n.star >= 0) { return; }
+	GetOrbitsInnermostFirst(n.primary, pairs);
+	GetOrbitsInnermostFirst(n.companion, pairs);
+	pairs.push_back(node);
+}
+
+///////////////////////////////////////
+// MUTATORS
+///////////////////////////////////////
+
+/* AddStar
+ * Adds the next star, named A, B, C... in turn, as a node of its own; the
+ * first star is the root until a pair takes it in
+ * Returns the node.
+ */
+int StarSystem::AddStar (const Star & s) {
+	StellarNode n;
+	n.star = stars.size();
+	n.name = string(1, (char) ('A' + n.star));
+	stars.push_back(s);
+	nodes.push_back(n);
+	int node = nodes.size() - 1;
+	if (root < 0) { root = node; }
+	return node;
+}
+
+/* AddPair
+ * Puts two nodes in orbit about each other
+ * Returns the new node, which becomes the root.
+ */
+int StarSystem::AddPair (int primary, int companion, OverallSeparation orbit) {
+	StellarNode n;
+	n.primary = primary;
+	n.companion = companion;
+	n.orbit = orbit;
+	n.name = nodes[primary].name + nodes[companion].name;
+	nodes.push_back(n);
+	int node = nodes.size() - 1;
+	nodes[primary].parent = node;
+	nodes[companion].parent = node;
+	root = node;
+	return node;
+}
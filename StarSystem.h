@@ -0,0 +1,85 @@
+#ifndef STARSYSTEM_H
+#define STARSYSTEM_H
+
+#include <vector>
+#include <string>
+#include <memory_resource>
+#include "Star.h"
+#include "Planet.h"
+#include "SystemArena.h"
+using namespace std;
+
+// struct for overall separation
+struct OverallSeparation {
+	double separation = 0.0;
+	double eccentricity = 0.0;
+};
+
+/* StellarNode
+ * One node of a system's hierarchy: a single star, or two nodes in orbit
+ * about each other, e.g. (AB)C is the pair of the pair AB and the star C.
+ */
+struct StellarNode {
+	int star = -1;           // a single star: its index in StarSystem::stars; -1 for a pair
+	int primary = -1;        // a pair: index in StarSystem::nodes of the side with the earlier star
+	int companion = -1;      // a pair: the other node
+	int parent = -1;         // the pair this node belongs to; -1 for the root
+	OverallSeparation orbit; // a pair: the companion's orbit about the primary
+	string name;             // the letters of its stars, e.g. "A" or "BC"
+};
+
+/* PlanetarySystem
+ * The planets of one protoplanetary disk, around a single star (S-type) or
+ * around both stars of a close pair (P-type, circumbinary)
+ */
+struct PlanetarySystem {
+	int host = -1;                   // the node the planets orbit
+	Star hostStar;                   // the host as formation saw it; a pair's masses and light are combined
+	bool circumbinary = false;
+	double forbiddenZone = 0.0;      // outermost stable orbit, set by the rest of the system
+	double innerExclusionZone = 0.0; // circumbinary: innermost stable orbit
+	double initialLuminosity = 0.0;  // the host's light when the disk formed
+	bool grandTack = false;          // whether a giant migrated in and back out during formation
+	pmr::vector<PlanetClass> formedClasses{systemMemory()}; // each planet's class as formation left it, before its age refines it
+	pmr::vector<Planet> planets{systemMemory()};
+
+	// Constructors: a copy draws from systemMemory() as a new one would
+	PlanetarySystem() = default;
+	PlanetarySystem(const PlanetarySystem & other) { *this = other; }
+	PlanetarySystem(PlanetarySystem &&) = default;
+	PlanetarySystem & operator= (const PlanetarySystem &) = default;
+	PlanetarySystem & operator= (PlanetarySystem &&) = default;
+};
+
+/* StarSystem
+ * Everything GenerateSystem produces for one seed
+ * The stars are A, B, C... in the order they were generated, A the most
+ * massive at birth; nodes holds one leaf per star and one node per pair,
+ * and root is the node that takes in the whole system.  planetSystems has
+ * one entry per disk, the primary's first.  The containers, and those of
+ * copies, draw from the thread's SystemArena while an ArenaScope is active.
+ */
+struct StarSystem {
+	int seed = 0;
+	pmr::vector<Star> stars{systemMemory()};
+	pmr::vector<StellarNode> nodes{systemMemory()};
+	int root = -1;
+	pmr::vector<PlanetarySystem> planetSystems{systemMemory()};
+
+	// Constructors: a copy draws from systemMemory() as a new one would
+	StarSystem() = default;
+	StarSystem(const StarSystem & other) { *this = other; }
+	StarSystem(StarSystem &&) = default;
+	StarSystem & operator= (const StarSystem &) = default;
+	StarSystem & operator= (StarSystem &&) = default;
+	// Accessors
+	int GetMultiplicity () const { return stars.size(); }
+	double GetNodeMass (int node);
+	string DescribeHierarchy (int node);
+	void GetOrbitsInnermostFirst (int node, pmr::vector<int> & pairs);
+	// Mutators
+	int AddStar (const Star & s);
+	int AddPair (int primary, int companion, OverallSeparation orbit);
+};
+
+#endif // STARSYSTEM_H
@@ -0,0 +1,134 @@
+#include <memory_resource>
+#include <vector>
+#include <utility>          // pair
+#include <new>
+#include <cstdint>          // uintptr_t
+#include "SystemArena.h"
+using namespace std;
+
+// each thread's arena, and the one systemMemory hands out (null outside a scope)
+static thread_local SystemArena threadArena;
+static thread_local pmr::memory_resource * currentMemory = nullptr;
+
+SystemArena::SystemArena(size_t initialBytes)
+{
+	capacity = initialBytes;
+	block = (char *) ::operator new(capacity);
+	used = 0;
+	highWater = 0;
+	growths = 0;
+}
+
+SystemArena::~SystemArena()
+{
+	Reset();
+	::operator delete(block);
+}
+
+///////////////////////////////////////
+// ACCESSORS
+///////////////////////////////////////
+
+size_t SystemArena::GetCapacity () { return capacity; }
+size_t SystemArena::GetHighWater () { return highWater; }
+unsigned long SystemArena::GetGrowthCount () { return growths; }
+
+///////////////////////////////////////
+// MUTATORS
+///////////////////////////////////////
+
+/* Reset
+ * Takes back everything handed out since the last Reset; if that did not
+ * fit in the block, the block is replaced by one with room for it twice
+ */
+void SystemArena::Reset () {
+	for (size_t i = 0; i < overflow.size(); i++) {
+		::operator delete(overflow[i].first, align_val_t(overflow[i].second));
+	}
+	overflow.clear();
+
+	if (used > capacity) {
+		::operator delete(block);
+		capacity = 2 * used;
+		block = (char *) ::operator new(capacity);
+		growths++;
+	}
+	used = 0;
+}
+
+void * SystemArena::do_allocate (size_t bytes, size_t alignment) {
+	if (used <= capacity) {
+		uintptr_t next = (uintptr_t) (block + used);
+		size_t start = used + ((alignment - next % alignment) % alignment);
+		if (start + bytes <= capacity) {
+			used = start + bytes;
+			if (used > highWater) { highWater = used; }
+			return block + start;
+		}
+	}
+
+	// out of room: count it, so that the next Reset makes the block big enough
+	used = (used > capacity ? used : capacity) + bytes + alignment;
+	if (used > highWater) { highWater = used; }
+	void * p = ::operator new(bytes, align_val_t(alignment));
+	overflow.push_back(make_pair(p, alignment));
+	return p;
+}
+
+// memory is only taken back by Reset
+void SystemArena::do_deallocate (void * p, size_t bytes, size_t alignment) {
+}
+
+bool SystemArena::do_is_equal (const pmr::memory_resource & other) const noexcept {
+	return this == &other;
+}
+
+///////////////////////////////////////
+// ArenaScope
+///////////////////////////////////////
+
+pmr::memory_resource * systemMemory () {
+	if (currentMemory != nullptr) { return currentMemory; }
+	return pmr::new_delete_resource();
+}
+
+ArenaScope::ArenaScope()
+{
+	threadArena.Reset();
+	currentMemory = &threadArena;
+}
+
+ArenaScope::~ArenaScope()
+{
+	currentMemory = nullptr;
+}
+
+SystemArena & ArenaScope::GetArena () {
+	return threadArena;
+}
+
+///////////////////////////////////////
+// ArenaStringBuf
+///////////////////////////////////////
+
+ArenaStringBuf::ArenaStringBuf() : text(systemMemory())
+{
+}
+
+const pmr::string & ArenaStringBuf::GetText () {
+	return text;
+}
+
+void ArenaStringBuf::Clear () {
+	text.clear();
+}
+
+ArenaStringBuf::int_type ArenaStringBuf::overflow (int_type c) {
+	if (c != traits_type::eof()) { text.push_back(traits_type::to_char_type(c)); }
+	return traits_type::not_eof(c);
+}
+
+streamsize ArenaStringBuf::xsputn (const char * s, streamsize n) {
+	text.append(s, n);
+	return n;
+}
@@ -0,0 +1,96 @@
+#ifndef SYSTEMARENA_H
+#define SYSTEMARENA_H
+
+#include <memory_resource>
+#include <vector>
+#include <utility>
+#include <string>
+#include <streambuf>
+using namespace std;
+
+/* SystemArena
+ * Working memory for generating one system at a time on one thread.
+ * Allocations are carved one after another out of a single block and never
+ * given back individually; Reset takes the whole block back at once, ready
+ * for the next seed.  A system that does not fit takes what it is missing
+ * from the heap, and the next Reset grows the block to the most any system
+ * has needed, so once the block is large enough a batch does no heap
+ * allocation at all for the containers that draw from it.
+ */
+class SystemArena : public pmr::memory_resource
+{
+	public:
+		// Constructors
+		SystemArena(size_t initialBytes = 64 * 1024);
+		~SystemArena();
+		SystemArena(const SystemArena &) = delete;
+		SystemArena & operator= (const SystemArena &) = delete;
+		// Accessors
+		size_t GetCapacity ();      // size of the block
+		size_t GetHighWater ();     // most bytes any one system has used
+		unsigned long GetGrowthCount (); // times the block had to grow
+		// Mutators
+		void Reset ();
+	protected:
+		void * do_allocate (size_t bytes, size_t alignment) override;
+		void do_deallocate (void * p, size_t bytes, size_t alignment) override;
+		bool do_is_equal (const pmr::memory_resource & other) const noexcept override;
+	private:
+		char * block;
+		size_t capacity;
+		size_t used;        // bytes handed out since the last Reset, overflow included
+		size_t highWater;
+		unsigned long growths;
+		vector<pair<void *, size_t>> overflow; // heap blocks taken since the last Reset, with their alignment
+};
+
+/* systemMemory
+ * Where per-system containers should allocate: this thread's arena inside
+ * an ArenaScope, or the heap outside of one.  Containers must take it when
+ * they are constructed: a plain copy of a pmr container goes to the heap.
+ */
+pmr::memory_resource * systemMemory ();
+
+/* ArenaScope
+ * Starts a new system on this thread's arena: the arena is reset, and
+ * systemMemory returns it until the scope ends.  Scopes do not nest, and
+ * everything allocated from the arena in one scope must be gone before the
+ * next scope on the same thread begins.
+ */
+class ArenaScope
+{
+	public:
+		// Constructors
+		ArenaScope();
+		~ArenaScope();
+		ArenaScope(const ArenaScope &) = delete;
+		ArenaScope & operator= (const ArenaScope &) = delete;
+		// Accessors
+		SystemArena & GetArena ();
+};
+
+/* ArenaStringBuf
+ * Stream buffer that collects what is written to it in a string drawn from
+ * systemMemory, for pages rendered inside an ArenaScope:
+ *   ArenaStringBuf buffer;
+ *   ostream page(&buffer);
+ * Clear empties it but keeps the room, for a buffer that is written again
+ * and again.
+ */
+class ArenaStringBuf : public streambuf
+{
+	public:
+		// Constructors
+		ArenaStringBuf();
+		// Accessors
+		const pmr::string & GetText ();
+		// Mutators
+		void Clear ();
+	protected:
+		int_type overflow (int_type c) override;
+		streamsize xsputn (const char * s, streamsize n) override;
+	private:
+		pmr::string text;
+};
+
+#endif // SYSTEMARENA_H
@@ -0,0 +1,259 @@
+#include <vector>
+#include <cmath>
+#include <cstdint>          // uint64_t
+#include <cstring>          // memcpy
+#include "SystemBatch.h"
+#include "StarSystem.h"
+#include "Planet.h"
+#include "Generator.h"
+using namespace std;
+
+// each pass is built for these, and the loader picks one; see SystemBatch.h
+#define BATCH_PASS __attribute__((target_clones("avx512f", "avx2", "default")))
+
+// Function declarations
+static inline double cubeRoot (double x);
+
+///////////////////////////////////////
+// MUTATORS
+///////////////////////////////////////
+
+/* Add
+ * Appends the planets of every disk in SYSTEM, the first disk's first
+ */
+void SystemBatch::Add (StarSystem & system) {
+	for (size_t d = 0; d < system.planetSystems.size(); d++) {
+		PlanetarySystem & disk = system.planetSystems[d];
+		AddDisk(disk, system.seed, getDiskComponent(system, disk));
+	}
+}
+
+/* AddDisk
+ * Appends the planets of one disk, whose streams are those of SEED and
+ * COMPONENT
+ */
+void SystemBatch::AddDisk (const PlanetarySystem & disk, int seed, int component) {
+	double typical = getTypicalEccentricity(disk.planets.size());
+	for (size_t i = 0; i < disk.planets.size(); i++) {
+		const Planet & p = disk.planets[i];
+		distance.push_back(p.GetDistance());
+		mass.push_back(p.GetMass());
+		density.push_back(p.GetDensity());
+		planetoidBelt.push_back(disk.formedClasses[i] == PLANETOID_BELT);
+		typicalEccentricity.push_back(typical);
+		eccentricityOffset.push_back(rollEccentricityOffset(seed, component, i));
+		hostMass.push_back(disk.hostStar.GetMass());
+		hostAge.push_back(disk.hostStar.GetAge());
+		hostLuminosity.push_back(disk.hostStar.GetLuminosity());
+	}
+	size_t n = Size();
+	eccentricity.resize(n);
+	radius.resize(n);
+	gravity.resize(n);
+	orbitalPeriod.resize(n);
+	tideLockRadius.resize(n);
+	tidallyLocked.resize(n);
+	lockedRotationPeriod.resize(n);
+	blackBodyTemperature.resize(n);
+}
+
+/* Apply
+ * Writes the passes' results back into SYSTEM, whose planets were added
+ * starting at FIRST; see ApplyDisk
+ * Returns the index just past the system's planets.
+ */
+size_t SystemBatch::Apply (StarSystem & system, size_t first) {
+	for (size_t d = 0; d < system.planetSystems.size(); d++) {
+		first = ApplyDisk(system.planetSystems[d], first);
+	}
+	return first;
+}
+
+/* ApplyDisk
+ * Writes the passes' results back into DISK, whose planets were added
+ * starting at FIRST: eccentricity, radius, gravity, orbital period, and the
+ * rotation period of tidally locked planets.  The black-body temperature
+ * is the surface stage's business.
+ * Returns the index just past the disk's planets.
+ */
+size_t SystemBatch::ApplyDisk (PlanetarySystem & disk, size_t first) {
+	size_t j = first;
+	pmr::vector<Planet> & planets = disk.planets;
+	for (size_t i = 0; i < planets.size(); i++, j++) {
+		planets[i].SetEccentricity(eccentricity[j]);
+		planets[i].SetRadius(radius[j]);
+		planets[i].SetGravity(gravity[j]);
+		planets[i].SetOrbitalPeriod(orbitalPeriod[j]);
+		if (tidallyLocked[j]) { planets[i].SetRotationPeriod(lockedRotationPeriod[j]); }
+	}
+	return j;
+}
+
+void SystemBatch::Clear () {
+	distance.clear();
+	mass.clear();
+	density.clear();
+	planetoidBelt.clear();
+	typicalEccentricity.clear();
+	eccentricityOffset.clear();
+	hostMass.clear();
+	hostAge.clear();
+	hostLuminosity.clear();
+	eccentricity.clear();
+	radius.clear();
+	gravity.clear();
+	orbitalPeriod.clear();
+	tideLockRadius.clear();
+	tidallyLocked.clear();
+	lockedRotationPeriod.clear();
+	blackBodyTemperature.clear();
+}
+
+///////////////////////////////////////
+// PASSES
+///////////////////////////////////////
+
+BATCH_PASS void batchEccentricities (SystemBatch & batch) {
+	const double * typical = batch.typicalEccentricity.data();
+	const double * offset = batch.eccentricityOffset.data();
+	double * eccen = batch.eccentricity.data();
+	size_t n = batch.Size();
+	for (size_t i = 0; i < n; i++) {
+		double e = typical[i] + offset[i];
+		eccen[i] = (e < 0) ? 0.0 : e;
+	}
+}
+
+BATCH_PASS void batchRadii (SystemBatch & batch) {
+	const double * mass = batch.mass.data();
+	const double * density = batch.density.data();
+	const unsigned char * belt = batch.planetoidBelt.data();
+	double * radius = batch.radius.data();
+	double * gravity = batch.gravity.data();
+	size_t n = batch.Size();
+	for (size_t i = 0; i < n; i++) {
+		// a belt's density is 0; its quotient is swapped out before the root
+		double ratio = mass[i] / density[i];
+		double r = cubeRoot(belt[i] ? 1.0 : ratio);
+		radius[i] = belt[i] ? 0.0 : r;
+		gravity[i] = belt[i] ? 0.0 : density[i] * r;
+	}
+}
+
+BATCH_PASS void batchOrbitalPeriods (SystemBatch & batch) {
+	const double * distance = batch.distance.data();
+	const double * hostMass = batch.hostMass.data();
+	double * period = batch.orbitalPeriod.data();
+	size_t n = batch.Size();
+	for (size_t i = 0; i < n; i++) {
+		double d = distance[i];
+		period[i] = sqrt(d * d * d / hostMass[i]);
+	}
+}
+
+BATCH_PASS void batchTidalLocking (SystemBatch & batch) {
+	const double * distance = batch.distance.data();
+	const double * eccentricity = batch.eccentricity.data();
+	const double * period = batch.orbitalPeriod.data();
+	const double * hostMass = batch.hostMass.data();
+	const double * hostAge = batch.hostAge.data();
+	double * tideLockRadius = batch.tideLockRadius.data();
+	unsigned char * locked = batch.tidallyLocked.data();
+	double * rotation = batch.lockedRotationPeriod.data();
+	size_t n = batch.Size();
+	for (size_t i = 0; i < n; i++) {
+		double m = hostMass[i];
+		// the sixth root, as the square root of the cube root
+		tideLockRadius[i] = sqrt(cubeRoot(hostAge[i] * (m * m) / 479.0));
+	}
+	// a loop of its own: a byte column among the doubles keeps the vectorizer out
+	for (size_t i = 0; i < n; i++) {
+		locked[i] = distance[i] < tideLockRadius[i];
+	}
+	for (size_t i = 0; i < n; i++) {
+		double year = period[i];
+		double e = eccentricity[i];
+		double r = year / 3.0;
+		r = (e <= 0.45) ? year * 2.0 / 5.0 : r;
+		r = (e <= 0.35) ? year / 2.0 : r;
+		r = (e <= 0.25) ? year * 2.0 / 3.0 : r;
+		r = (e <= 0.12) ? year : r;
+		rotation[i] = r * 8766; // in hours
+	}
+}
+
+BATCH_PASS void batchBlackBodyTemperatures (SystemBatch & batch) {
+	const double * distance = batch.distance.data();
+	const double * hostLuminosity = batch.hostLuminosity.data();
+	double * temperature = batch.blackBodyTemperature.data();
+	size_t n = batch.Size();
+	for (size_t i = 0; i < n; i++) {
+		temperature[i] = 278.0 * sqrt(sqrt(hostLuminosity[i])) / sqrt(distance[i]);
+	}
+}
+
+/* runBatchPasses
+ * Every pass, each after those it reads
+ */
+void runBatchPasses (SystemBatch & batch) {
+	batchEccentricities(batch);
+	batchRadii(batch);
+	batchOrbitalPeriods(batch);
+	batchTidalLocking(batch);
+	batchBlackBodyTemperatures(batch);
+}
+
+///////////////////////////////////////
+// HELPERS
+///////////////////////////////////////
+
+static inline uint64_t bitsOf (double x) {
+	uint64_t u;
+	memcpy(&u, &x, sizeof u);
+	return u;
+}
+
+static inline double fromBits (uint64_t u) {
+	double x;
+	memcpy(&x, &u, sizeof x);
+	return x;
+}
+
+/* powerOfTwo
+ * 2^K for a whole number K from -1022 to 1023: K + 1023 lands in the low
+ * bits of K + 1023 + 2^52, and from there is shifted into the exponent
+ */
+static inline double powerOfTwo (double k) {
+	return fromBits(bitsOf(k + 1023.0 + 4503599627370496.0) << 52);
+}
+
+/* cubeRoot
+ * The cube root of a positive normal X, to within an ulp or two, in
+ * arithmetic the vectorizer can widen (integer and double conversions are
+ * done by adding 2^52, so that SSE2 needs no instruction it lacks).
+ * X = 2^(3q + r) * m, m in [1, 2) and r in {0, 1, 2}, so its root is
+ * 2^q times the root of 2^r * m, which lies in [1, 8): a quadratic starts
+ * that within 2.5%, and four Newton steps finish it.  Zero for anything
+ * below the normal range.
+ */
+static inline double cubeRoot (double x) {
+	const double TWO_52 = 4503599627370496.0;
+	const double ROUNDING_BIAS = 6755399441055744.0; // 1.5 * 2^52
+	uint64_t bits = bitsOf(x);
+
+	double biasedExponent = fromBits(0x4330000000000000ULL | (bits >> 52)) - TWO_52;
+	double exponent = biasedExponent - 1023.0;
+	// the nearest integer to (exponent - 1) / 3 is the floor of exponent / 3
+	double q = ((exponent - 1.0) / 3.0 + ROUNDING_BIAS) - ROUNDING_BIAS;
+	double r = exponent - 3.0 * q;
+
+	double m = fromBits((bits & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL);
+	double z = m * powerOfTwo(r);
+	double y = 0.7859311861841896 + z * (0.2516312732803194 + z * -0.012815951708579253);
+	y = (2.0 * y + z / (y * y)) / 3.0;
+	y = (2.0 * y + z / (y * y)) / 3.0;
+	y = (2.0 * y + z / (y * y)) / 3.0;
+	y = (2.0 * y + z / (y * y)) / 3.0;
+
+	return (x < 2.2250738585072014e-308) ? 0.0 : y * powerOfTwo(q);
+}
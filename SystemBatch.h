@@ -0,0 +1,72 @@
+#ifndef SYSTEMBATCH_H
+#define SYSTEMBATCH_H
+
+#include <vector>
+#include <cstddef>
+#include "StarSystem.h"
+using namespace std;
+
+/* SystemBatch
+ * The planets of many systems at once, one array per quantity, for catalog
+ * work: the batch passes below are plain loops down these arrays that the
+ * compiler vectorizes.  Add appends every planet of a system, disk by disk,
+ * along with what each pass needs of its host star, so that no pass looks
+ * anything up; Apply writes the passes' results back into the system.
+ * AddDisk and ApplyDisk do the same for one disk, as a pipeline stage
+ * sees it.  GenSystem does not use it; only the benchmarks run it, the
+ * pipeline one through replaceStage.
+ */
+struct SystemBatch {
+	// read by the passes
+	vector<double> distance;
+	vector<double> mass;
+	vector<double> density;
+	vector<unsigned char> planetoidBelt;  // no radius or gravity
+	vector<double> typicalEccentricity;   // for the number of planets in its disk
+	vector<double> eccentricityOffset;    // the planet's own roll; see rollEccentricityOffset
+	vector<double> hostMass;
+	vector<double> hostAge;
+	vector<double> hostLuminosity;
+	// set by the passes
+	vector<double> eccentricity;
+	vector<double> radius;
+	vector<double> gravity;
+	vector<double> orbitalPeriod;
+	vector<double> tideLockRadius;        // AU
+	vector<unsigned char> tidallyLocked;
+	vector<double> lockedRotationPeriod;  // hours; meaningless unless tidallyLocked
+	vector<double> blackBodyTemperature;
+
+	void Add (StarSystem & system);
+	void AddDisk (const PlanetarySystem & disk, int seed, int component);
+	size_t Apply (StarSystem & system, size_t first);
+	size_t ApplyDisk (PlanetarySystem & disk, size_t first);
+	void Clear ();
+	size_t Size () const { return distance.size(); }
+};
+
+/* The batch passes
+ *   batchEccentricities      the typical eccentricity plus the planet's offset, at least 0
+ *   batchRadii               radius and surface gravity from mass and density
+ *   batchOrbitalPeriods      years, from distance and the host's mass
+ *   batchTidalLocking        whether the host has locked the planet, and its
+ *                            rotation period if so (needs the orbital periods)
+ *   batchBlackBodyTemperatures   kelvin, from distance and the host's light
+ *
+ * They follow the pipeline stages formula for formula, with pow
+ * taken apart into products, square roots and a cube root of their own,
+ * and agree with them to a relative BATCH_TOLERANCE (see StarBatch.h;
+ * measured: under 1e-15).  The eccentricities are exact, the random part
+ * having been drawn by Add from the planet's own stream.  A planet right
+ * at the tide-lock radius could in principle land on the other side of it.
+ * Each pass is compiled for AVX-512, AVX2 and the baseline, and the loader
+ * picks the widest this CPU runs.
+ */
+void batchEccentricities (SystemBatch & batch);
+void batchRadii (SystemBatch & batch);
+void batchOrbitalPeriods (SystemBatch & batch);
+void batchTidalLocking (SystemBatch & batch);
+void batchBlackBodyTemperatures (SystemBatch & batch);
+void runBatchPasses (SystemBatch & batch);
+
+#endif // SYSTEMBATCH_H
@@ -0,0 +1,103 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include "Planet.h"
+#include "HtmlWriter.h"
+#include "DecisionTrace.h"
+using namespace std;
+
+// Function declarations
+bool dumpTrace (string fileName);
+string describeFlags (int flags);
+
+/* MAIN
+ * Decodes trace files written by GenSystem --trace
+ * Usage: TraceDump FILE...
+ */
+int main (int argc, char **argv) {
+	if (argc < 2) {
+		cerr << "Usage: " << argv[0] << " FILE...\n";
+		exit(1);
+	}
+
+	bool ok = true;
+	for (int i = 1; i < argc; i++) {
+		if (!dumpTrace(argv[i])) { ok = false; }
+	}
+
+	return ok ? 0 : 1;
+}
+
+/* dumpTrace
+ * Prints one line per event, oldest first
+ */
+bool dumpTrace (string fileName) {
+	ifstream inFile(fileName.c_str(), ios::binary);
+	DecisionTrace trace(0);
+	if (inFile.fail() || !trace.Read(inFile)) {
+		cerr << fileName << ": not a GenSystem trace file\n";
+		return false;
+	}
+
+	cout << fileName << ": seed " << trace.GetSeed() << ", " << trace.GetEventCount() << " events";
+	if (trace.GetDroppedCount() > 0) { cout << " (" << trace.GetDroppedCount() << " older events dropped)"; }
+	cout << "\n";
+
+	for (int i = 0; i < trace.GetEventCount(); i++) {
+		TraceEvent event = trace.GetEvent(i);
+		cout << "  " << traceStageName(event.stage);
+		if (event.planet >= 0) { cout << " planet " << (int) event.planet; }
+
+		switch (event.stage) {
+			case TRACE_DISK_MASS_FACTOR:
+			case TRACE_MIGRATION_FACTOR:
+				cout << ": " << event.value;
+				break;
+			case TRACE_EXCLUSION_ZONE:
+				cout << ": at " << event.value << " AU";
+				break;
+			case TRACE_OUTER_SYSTEM_ROLL:
+				cout << ": rolled " << event.roll << " (modifier " << event.outcome << ")";
+				break;
+			case TRACE_INWARD_MIGRATION:
+				cout << ": moved to " << event.value << " AU";
+				break;
+			case TRACE_GRAND_TACK_ROLL:
+				cout << ": rolled " << event.roll << (event.outcome ? ", tack" : ", no tack");
+				break;
+			case TRACE_GRAND_TACK_DISTANCE:
+				cout << ": rolled " << event.roll << ", moved to " << event.value << " AU";
+				break;
+			case TRACE_NICE_ROLL:
+			case TRACE_INNER_MIGRATION_ROLL:
+				cout << ": rolled " << event.roll << (event.outcome ? ", ejected" : ", stays");
+				break;
+			case TRACE_PLANET_RESULT: {
+				const char * className;
+				const char * imgFileName;
+				printPlanetaryClass((PlanetClass) event.outcome, className, imgFileName);
+				cout << ": " << className << " at " << event.value << " AU" << describeFlags(event.roll);
+				break;
+			}
+			case TRACE_DISK_HOST:
+				cout << ": around " << (char) ('A' + event.outcome) << (event.roll ? " and its companion" : "") << ", stable out to " << event.value << " AU";
+				break;
+			default:
+				cout << ": roll " << event.roll << ", outcome " << event.outcome << ", value " << event.value;
+				break;
+		}
+		cout << "\n";
+	}
+
+	return true;
+}
+
+string describeFlags (int flags) {
+	string text;
+	if (flags & TRACE_FLAG_EJECTED) { text += ", ejected"; }
+	if (flags & TRACE_FLAG_EXCLUDED) { text += ", in exclusion zone"; }
+	if (flags & TRACE_FLAG_DISRUPTED) { text += ", orbit disrupted"; }
+	if (flags & TRACE_FLAG_GRAND_TACK) { text += ", moved by grand tack"; }
+	text += (flags & TRACE_FLAG_KEPT) ? ", kept" : ", eliminated";
+	return text;
+}
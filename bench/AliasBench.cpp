@@ -0,0 +1,96 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include "../Generator.h"
+#include "../RandomEngine.h"
+#include "../Distributions.h"
+#include "../AliasTable.h"
+#include "../Log.h"
+using namespace std;
+
+// Function declarations
+double chainedDiskMassFactor (RandomEngine & e);
+double secondsSince (chrono::steady_clock::time_point start);
+
+// the disk mass table of generateDiskMassFactor
+constexpr AliasTable<9> DISK_MASS = makeThreeD6Table<9>({ 3, 5, 7, 9, 11, 13, 15, 17, 18 });
+const double DISK_MASS_VALUES[9] = { 0.25, 0.36, 0.50, 0.70, 1.00, 1.40, 2.00, 2.80, 4.00 };
+
+/* MAIN
+ * Alias table benchmark; built by "make bench"
+ * Times the disk mass table rolled as three dice and an if/else chain
+ * against the same table as one alias table sample, then generates COUNT
+ * full systems (default 5000) and prints the table samples each system
+ * takes and the dice rolls, engine draws and if/else comparisons they save.
+ * Usage: AliasBench [COUNT]
+ */
+int main (int argc, char **argv) {
+	int count = 5000;
+	if (argc > 1) { count = atoi(argv[1]); }
+	setLogLevel(LOG_QUIET);
+	setParallelFormation(false); // the counters are per thread
+
+	const int samples = 20000000;
+	RandomEngine e = makeStream(42, 0, 0, STAGE_DISK);
+	double sum = 0;
+
+	randomDrawCount = 0;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (int i = 0; i < samples; i++) { sum += chainedDiskMassFactor(e); }
+	double chainSeconds = secondsSince(start);
+	double chainDraws = (double) randomDrawCount / samples;
+
+	randomDrawCount = 0;
+	start = chrono::steady_clock::now();
+	for (int i = 0; i < samples; i++) { sum += DISK_MASS_VALUES[DISK_MASS(e)]; }
+	double aliasSeconds = secondsSince(start);
+	double aliasDraws = (double) randomDrawCount / samples;
+	// keep the loops from being optimised away
+	if (sum == 42) { cout << ""; }
+
+	cout << RANDOM_ENGINE_NAME << " disk mass table: 3d6 + if/else " << samples / chainSeconds / 1e6 << " M/s, ";
+	cout << chainDraws << " draws, " << DISK_MASS.branchesReplaced << " comparisons; ";
+	cout << "alias " << samples / aliasSeconds / 1e6 << " M/s, " << aliasDraws << " draws, 1 comparison\n";
+
+	GenerationOptions options;
+	randomDrawCount = 0;
+	aliasSampleCount = 0;
+	aliasRollsSaved = 0;
+	aliasBranchesSaved = 0;
+	for (int seed = 1; seed <= count; seed++) {
+		GenerateSystem(seed, options);
+	}
+	// every roll saved was as many draws as one canonical sample takes
+	double range = (double) RandomEngine::max() - (double) RandomEngine::min() + 1.0;
+	double drawsPerRoll = (range >= 18446744073709551616.0) ? 1 : 2;
+
+	cout << RANDOM_ENGINE_NAME << " per system over " << count << " systems: ";
+	cout << (double) aliasSampleCount / count << " table samples, saving ";
+	cout << (double) aliasRollsSaved / count << " dice rolls (";
+	cout << aliasRollsSaved * drawsPerRoll / count << " of " << (double) (randomDrawCount + aliasRollsSaved * drawsPerRoll) / count << " draws) and ";
+	cout << aliasBranchesSaved / count << " if/else comparisons\n";
+
+	return 0;
+}
+
+/* chainedDiskMassFactor
+ * generateDiskMassFactor as it was before the alias tables
+ */
+double chainedDiskMassFactor (RandomEngine & e) {
+	UniformIntDistribution diceRoll(1, 6);
+	int roll = diceRoll(e) + diceRoll(e) + diceRoll(e);
+
+	if (roll == 3) { return 0.25; }
+	else if (roll <= 5) { return 0.36; }
+	else if (roll <= 7) { return 0.50; }
+	else if (roll <= 9) { return 0.70; }
+	else if (roll <= 11) { return 1.00; }
+	else if (roll <= 13) { return 1.40; }
+	else if (roll <= 15) { return 2.00; }
+	else if (roll <= 17) { return 2.80; }
+	else { return 4.00; }
+}
+
+double secondsSince (chrono::steady_clock::time_point start) {
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,104 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include "../StarBatch.h"
+#include "../Distributions.h"
+#include "../RandomEngine.h"
+using namespace std;
+
+// Function declarations
+double worstRelativeError (const vector<double> & a, const vector<double> & b, const vector<unsigned char> & use);
+double secondsSince (chrono::steady_clock::time_point start);
+
+/* MAIN
+ * Batch kernel benchmark; built by "make bench"
+ * Runs every batch kernel this CPU supports over COUNT stars (default
+ * 1000000), prints stars per second for the IMF and the main sequence, and
+ * checks each vector kernel against the scalar one.  Exits with 1 if any
+ * differs by more than BATCH_TOLERANCE.
+ * Usage: BatchBench [COUNT]
+ */
+int main (int argc, char **argv) {
+	size_t count = 1000000;
+	if (argc > 1) { count = atol(argv[1]); }
+
+	RandomEngine e = makeStream(42, 0, 0, STAGE_PRIMARY);
+	vector<double> uniforms(2 * count);
+	vector<double> ages(count);
+	UniformRealDistribution randU(0, 1);
+	UniformRealDistribution randAge(0, 13.5);
+	randU.Fill(e, uniforms.data(), uniforms.size());
+	randAge.Fill(e, ages.data(), ages.size());
+
+	StarBatch reference;
+	bool ok = true;
+	BatchKernelLevel levels[3] = { BATCH_SCALAR, BATCH_AVX2, BATCH_AVX512 };
+	for (int l = 0; l < 3; l++) {
+		const BatchKernels * kernels = getBatchKernels(levels[l]);
+		if (kernels == nullptr) { continue; }
+
+		StarBatch stars;
+		stars.Resize(count);
+		stars.age = ages;
+
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		kernels->initialMasses(uniforms.data(), stars.mass.data(), count);
+		double imfSeconds = secondsSince(start);
+		vector<double> masses = stars.mass;
+		// the main sequence is compared on the same masses, since a last-bit
+		// difference can put a star on the other side of a breakpoint
+		if (levels[l] != BATCH_SCALAR) { stars.mass = reference.mass; }
+
+		start = chrono::steady_clock::now();
+		kernels->mainSequence(stars.mass.data(), stars.age.data(), stars.luminosity.data(), stars.temperature.data(), stars.radius.data(), stars.onMainSequence.data(), count);
+		double evolutionSeconds = secondsSince(start);
+
+		cout << kernels->name << ": IMF " << count / imfSeconds / 1e6 << " M stars/s, main sequence " << count / evolutionSeconds / 1e6 << " M stars/s";
+		stars.mass = masses;
+		if (levels[l] == BATCH_SCALAR) {
+			reference = stars;
+			cout << "\n";
+			continue;
+		}
+
+		vector<unsigned char> all(count, 1);
+		double massError = worstRelativeError(stars.mass, reference.mass, all);
+		double lumError = worstRelativeError(stars.luminosity, reference.luminosity, reference.onMainSequence);
+		double tempError = worstRelativeError(stars.temperature, reference.temperature, reference.onMainSequence);
+		double radiusError = worstRelativeError(stars.radius, reference.radius, reference.onMainSequence);
+		bool sameFlags = stars.onMainSequence == reference.onMainSequence;
+		cout << "; worst relative error vs scalar: mass " << massError << ", luminosity " << lumError;
+		cout << ", temperature " << tempError << ", radius " << radiusError;
+		cout << (sameFlags ? "" : "; MAIN-SEQUENCE FLAGS DIFFER") << "\n";
+
+		if (!sameFlags || massError > BATCH_TOLERANCE || lumError > BATCH_TOLERANCE || tempError > BATCH_TOLERANCE || radiusError > BATCH_TOLERANCE) {
+			ok = false;
+		}
+	}
+	cout << "dispatch picks " << bestBatchKernels().name << "\n";
+
+	if (!ok) {
+		cerr << "Batch kernels exceed the tolerance of " << BATCH_TOLERANCE << ".\n";
+		return 1;
+	}
+	return 0;
+}
+
+/* worstRelativeError
+ * Over the stars whose USE flag is set
+ */
+double worstRelativeError (const vector<double> & a, const vector<double> & b, const vector<unsigned char> & use) {
+	double worst = 0;
+	for (size_t i = 0; i < a.size(); i++) {
+		if (!use[i]) { continue; }
+		double error = fabs(a[i] - b[i]) / fabs(b[i]);
+		if (!(error <= worst)) { worst = error; }
+	}
+	return worst;
+}
+
+double secondsSince (chrono::steady_clock::time_point start) {
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
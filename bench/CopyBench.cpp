@@ -0,0 +1,208 @@
+#include <iostream>
+#include <iomanip>          // setw
+#include <cstdlib>
+#include <vector>
+#include <array>
+#include "../Generator.h"
+#include "../HtmlWriter.h"
+#include "../JsonWriter.h"
+#include "../CopyCounter.h"
+#include "../Log.h"
+using namespace std;
+
+#ifndef COUNT_COPIES
+#error "CopyBench counts copies through the COUNT_COPIES hooks; build it with make bench"
+#endif
+
+enum CopyStep { COPY_GENERATE, COPY_EVOLVE, COPY_HTML, COPY_JSON, COPY_STEPS };
+
+// Function declarations
+void generationBefore (const StarSystem & system);
+void evolutionBefore (const StarSystem & system);
+void htmlBefore (const StarSystem & system);
+void jsonBefore (const StarSystem & system);
+
+/* MAIN
+ * Copy benchmark; built by "make bench" with COUNT_COPIES
+ * Generates COUNT systems (default 5000), evolves each to a second age and
+ * renders it as HTML and as JSON, and prints the bytes of stars, planets,
+ * moons and atmospheres copied per system at each step, as counted by the
+ * copy constructors and assignments of those types (CopyCounter.h).
+ * Next to each it prints what the code copied before it took const
+ * references and built planets in place: the "before" functions below make,
+ * from each finished system, the copies the old code made, through the same
+ * counted constructors.
+ * Usage: CopyBench [COUNT]
+ */
+int main (int argc, char **argv) {
+	int count = 5000;
+	if (argc > 1) { count = atoi(argv[1]); }
+	setLogLevel(LOG_QUIET);
+	setParallelFormation(false); // the counter is per thread
+
+	GenerationOptions options;
+	ostream discard(nullptr);
+	unsigned long long now[COPY_STEPS] = {};
+	unsigned long long before[COPY_STEPS] = {};
+	for (int seed = 1; seed <= count; seed++) {
+		bytesCopied = 0;
+		StarSystem system = GenerateSystem(seed, options);
+		now[COPY_GENERATE] += bytesCopied;
+
+		bytesCopied = 0;
+		StarSystem older = EvolveSystem(system, 13.0);
+		now[COPY_EVOLVE] += bytesCopied;
+
+		bytesCopied = 0;
+		WriteSystemHtml(discard, system);
+		now[COPY_HTML] += bytesCopied;
+
+		bytesCopied = 0;
+		WriteSystemJson(discard, system);
+		now[COPY_JSON] += bytesCopied;
+
+		bytesCopied = 0;
+		generationBefore(system);
+		before[COPY_GENERATE] += bytesCopied;
+
+		bytesCopied = 0;
+		evolutionBefore(system);
+		before[COPY_EVOLVE] += bytesCopied;
+
+		bytesCopied = 0;
+		htmlBefore(system);
+		before[COPY_HTML] += bytesCopied;
+
+		bytesCopied = 0;
+		jsonBefore(system);
+		before[COPY_JSON] += bytesCopied;
+	}
+
+	static const char * stepNames[COPY_STEPS] = { "generating", "evolving to another age", "writing HTML", "writing JSON" };
+	cout << "Bytes copied per system over " << count << " systems:\n";
+	cout << "  " << left << setw(26) << "" << right << setw(10) << "before" << setw(10) << "now" << "\n";
+	cout << fixed << setprecision(0);
+	for (int s = 0; s < COPY_STEPS; s++) {
+		cout << "  " << left << setw(26) << stepNames[s] << right;
+		cout << setw(10) << (double) before[s] / count << setw(10) << (double) now[s] / count << "\n";
+	}
+
+	return 0;
+}
+
+///////////////////////////////////////
+// BEFORE
+///////////////////////////////////////
+
+/* generationBefore
+ * The copies GenerateSystem made of SYSTEM before:
+ *   AddStar pushed each star, and the vector moved those already there as
+ *     it grew
+ *   findDisks copied each host star into its disk (unless circumbinary),
+ *     then the disk into the system, whose vector was not reserved, so
+ *     every disk already there was copied as it grew
+ *   formPlanets copied its host star, built each of the twelve formation
+ *     slots as a temporary and copied it in, copied every slot again when
+ *     picking the survivors, and pushed the survivors onto a vector of its
+ *     own
+ *   each placed moon went into a local array, which SetMoons took by value
+ *     and then copied into the planet
+ *   each atmosphere was passed to SetAtmosphere by value and copied in
+ */
+void generationBefore (const StarSystem & system) {
+	vector<Star> stars;
+	for (const Star & s : system.stars) { stars.push_back(s); }
+
+	vector<Star> diskHosts;
+	for (const PlanetarySystem & disk : system.planetSystems) {
+		Star host;
+		if (!disk.circumbinary) { host = disk.hostStar; }
+		diskHosts.push_back(host);
+	}
+
+	for (const PlanetarySystem & disk : system.planetSystems) {
+		Star s = disk.hostStar;
+
+		array<Planet, 12> slots;
+		for (Planet & slot : slots) {
+			Planet temp;
+			slot = temp;
+		}
+
+		vector<Planet> survivors;
+		for (size_t i = 0; i < slots.size(); i++) {
+			Planet temp = slots[i];
+			if (i < disk.planets.size()) { survivors.push_back(temp); }
+		}
+
+		for (size_t i = 0; i < survivors.size(); i++) {
+			const Planet & p = disk.planets[i];
+			array<Moon, 10> moonArray;
+			for (int j = 0; j < p.GetNumberOfMoons(); j++) {
+				Moon temp(p.GetMoons()[j].GetDistance(), p.GetMoons()[j].GetMass());
+				moonArray[j] = temp;
+			}
+			array<Moon, 10> parameter = moonArray;
+			survivors[i].SetMoons(parameter);
+
+			if (p.GetAtmosphere().pressure != 0) {
+				Atmosphere atmos;
+				Atmosphere byValue = atmos;
+				survivors[i].SetAtmosphere(byValue);
+			}
+		}
+	}
+}
+
+/* evolutionBefore
+ * The copies EvolveSystem made before: it took the system by value (every
+ * star, and every disk with its host star and planets), copied each host
+ * star again in setHostStar unless the disk is circumbinary, and passed
+ * each atmosphere to SetAtmosphere by value
+ */
+void evolutionBefore (const StarSystem & system) {
+	vector<Star> stars(system.stars.begin(), system.stars.end());
+	for (const PlanetarySystem & disk : system.planetSystems) {
+		Star host = disk.hostStar;
+		vector<Planet> planets(disk.planets.begin(), disk.planets.end());
+		if (!disk.circumbinary) { host = disk.hostStar; }
+		for (Planet & p : planets) {
+			if (p.GetAtmosphere().pressure != 0) {
+				Atmosphere atmos;
+				Atmosphere byValue = atmos;
+				p.SetAtmosphere(byValue);
+			}
+		}
+	}
+}
+
+/* htmlBefore
+ * The copies WriteSystemHtml made before: each rocky planet's atmosphere and
+ * each moon table, as GetAtmosphere and GetMoons returned them by value
+ */
+void htmlBefore (const StarSystem & system) {
+	for (const PlanetarySystem & disk : system.planetSystems) {
+		for (const Planet & p : disk.planets) {
+			PlanetClass pc = p.GetPlanetClass();
+			if (pc == TERRESTRIAL_PLANET || pc == LEFTOVER_OLIGARCH || pc == VENUSIAN || pc == HYCEAN || pc == TITANIAN || pc == GAIAN || pc == MARTIAN) {
+				Atmosphere a = p.GetAtmosphere();
+			}
+			if (p.GetNumberOfMoons() != 0) {
+				array<Moon, 10> theMoons = p.GetMoons();
+			}
+		}
+	}
+}
+
+/* jsonBefore
+ * The copies WriteSystemJson made before: every planet's atmosphere and
+ * moons, as GetAtmosphere and GetMoons returned them by value
+ */
+void jsonBefore (const StarSystem & system) {
+	for (const PlanetarySystem & disk : system.planetSystems) {
+		for (const Planet & p : disk.planets) {
+			Atmosphere a = p.GetAtmosphere();
+			array<Moon, 10> theMoons = p.GetMoons();
+		}
+	}
+}
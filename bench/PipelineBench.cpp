@@ -0,0 +1,153 @@
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include "../Generator.h"
+#include "../FormationPipeline.h"
+#include "../SystemBatch.h"
+#include "../StarBatch.h"
+#include "../JsonWriter.h"
+#include "../SystemArena.h"
+#include "../Log.h"
+using namespace std;
+
+// Function declarations
+void runBatchOrbitsStage (DiskJob * jobs, size_t count);
+string describe (StarSystem & system);
+double secondsSince (chrono::steady_clock::time_point start);
+
+/* MAIN
+ * Pipeline benchmark; built by "make bench"
+ * Generates COUNT systems (default 20000) one at a time, then in batches
+ * of BATCH (default 64) with each pipeline stage run over the whole batch
+ * before the next, and prints systems per second for both and the time
+ * each stage takes per system.  Then runs the pipeline with its "orbits"
+ * stage replaced by the SystemBatch passes.  Exits with 1 if the batched
+ * systems differ from those made one at a time, or the replaced stage's
+ * periods differ by more than BATCH_TOLERANCE.
+ * Usage: PipelineBench [COUNT [BATCH]]
+ */
+int main (int argc, char **argv) {
+	int count = 20000;
+	int batch = 64;
+	if (argc > 1) { count = atoi(argv[1]); }
+	if (argc > 2) { batch = atoi(argv[2]); }
+	setLogLevel(LOG_QUIET);
+	setParallelFormation(false); // one thread for both, as in a -j batch run
+
+	GenerationOptions options;
+	vector<int> seeds;
+	for (int seed = 1; seed <= count; seed++) { seeds.push_back(seed); }
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (int i = 0; i < count; i++) {
+		ArenaScope scope;
+		GenerateSystem(seeds[i], options);
+	}
+	double singleSeconds = secondsSince(start);
+
+	start = chrono::steady_clock::now();
+	for (int first = 0; first < count; first += batch) {
+		ArenaScope scope;
+		GenerateSystems(&seeds[first], min(batch, count - first), options);
+	}
+	double batchSeconds = secondsSince(start);
+
+	cout << count << " systems: one at a time " << count / singleSeconds << " systems/s, in batches of " << batch;
+	cout << " " << count / batchSeconds << " systems/s\n";
+
+	// each stage's share, and whether batching changed anything
+	const Pipeline & pipeline = generationPipeline();
+	vector<double> stageSeconds(pipeline.size(), 0.0);
+	size_t differences = 0;
+	for (int first = 0; first < count; first += batch) {
+		ArenaScope scope;
+		int n = min(batch, count - first);
+		pmr::vector<StarSystem> systems(systemMemory());
+		for (int i = 0; i < n; i++) { systems.push_back(GenerateStars(seeds[first + i], options)); }
+		formPlanetarySystems(systems.data(), n, pipeline, stageSeconds.data());
+		for (int i = 0; i < n; i++) {
+			StarSystem single = GenerateSystem(seeds[first + i], options);
+			if (describe(systems[i]) != describe(single)) { differences++; }
+		}
+	}
+	cout << "per system:";
+	for (size_t s = 0; s < pipeline.size(); s++) {
+		cout << (s == 0 ? " " : ", ") << pipeline[s].name << " " << stageSeconds[s] / count * 1e6 << " us";
+	}
+	cout << "; " << differences << " systems differ from those made one at a time\n";
+
+	// the same batches with the orbits stage replaced
+	Pipeline replaced = pipeline;
+	replaceStage(replaced, "orbits", runBatchOrbitsStage);
+	vector<double> replacedSeconds(replaced.size(), 0.0);
+	double worst = 0;
+	for (int first = 0; first < count; first += batch) {
+		ArenaScope scope;
+		int n = min(batch, count - first);
+		pmr::vector<StarSystem> systems(systemMemory());
+		for (int i = 0; i < n; i++) { systems.push_back(GenerateStars(seeds[first + i], options)); }
+		formPlanetarySystems(systems.data(), n, replaced, replacedSeconds.data());
+		for (int i = 0; i < n; i++) {
+			StarSystem single = GenerateSystem(seeds[first + i], options);
+			for (size_t d = 0; d < single.planetSystems.size(); d++) {
+				for (size_t p = 0; p < single.planetSystems[d].planets.size(); p++) {
+					double a = systems[i].planetSystems[d].planets[p].GetOrbitalPeriod();
+					double b = single.planetSystems[d].planets[p].GetOrbitalPeriod();
+					if (a != b && !(fabs(a - b) / fabs(b) <= worst)) { worst = fabs(a - b) / fabs(b); }
+				}
+			}
+		}
+	}
+	size_t orbits = 0;
+	while (string(pipeline[orbits].name) != "orbits") { orbits++; }
+	cout << "orbits stage replaced by the SystemBatch passes: " << stageSeconds[orbits] / count * 1e6 << " -> ";
+	cout << replacedSeconds[orbits] / count * 1e6 << " us per system; worst relative error in the periods " << worst << "\n";
+
+	if (differences > 0 || worst > BATCH_TOLERANCE) {
+		cerr << "The pipeline does not reproduce GenerateSystem.\n";
+		return 1;
+	}
+	return 0;
+}
+
+/* runBatchOrbitsStage
+ * The "orbits" stage over SystemBatch: the classes are reset one disk at
+ * a time as before, and the periods come from batchOrbitalPeriods
+ */
+void runBatchOrbitsStage (DiskJob * jobs, size_t count) {
+	static thread_local SystemBatch planets;
+	planets.Clear();
+	for (size_t i = 0; i < count; i++) {
+		PlanetarySystem & disk = *jobs[i].disk;
+		for (size_t p = 0; p < disk.planets.size(); p++) {
+			disk.planets[p].SetPlanetClass(disk.formedClasses[p]);
+		}
+		// only the columns this pass reads
+		for (size_t p = 0; p < disk.planets.size(); p++) {
+			planets.distance.push_back(disk.planets[p].GetDistance());
+			planets.hostMass.push_back(disk.hostStar.GetMass());
+		}
+	}
+	planets.orbitalPeriod.resize(planets.Size());
+	batchOrbitalPeriods(planets);
+	size_t j = 0;
+	for (size_t i = 0; i < count; i++) {
+		pmr::vector<Planet> & diskPlanets = jobs[i].disk->planets;
+		for (size_t p = 0; p < diskPlanets.size(); p++, j++) {
+			diskPlanets[p].SetOrbitalPeriod(planets.orbitalPeriod[j]);
+		}
+	}
+}
+
+string describe (StarSystem & system) {
+	ostringstream out;
+	WriteSystemJson(out, system);
+	return out.str();
+}
+
+double secondsSince (chrono::steady_clock::time_point start) {
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
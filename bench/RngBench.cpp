@@ -0,0 +1,97 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include "../Generator.h"
+#include "../RandomEngine.h"
+#include "../Log.h"
+using namespace std;
+
+// Function declarations
+template <class Engine> double rawDrawsPerSecond (unsigned long long draws);
+double secondsSince (chrono::steady_clock::time_point start);
+void printDrawsPerSeed (const char * stage, vector<unsigned long long> & draws, int firstSeed);
+
+/* MAIN
+ * Random engine benchmark; built once per engine by "make bench"
+ * Prints raw draws per second for every engine, then generates COUNT full
+ * systems (default 5000) with the engine this copy was compiled with and
+ * prints how many draws they made and how fast.  Then shows how the draws are
+ * spread over the seeds, for the stars alone and for the full system: a seed
+ * that needs many more draws than the median is one that is slow to generate.
+ * Usage: RngBench [COUNT]
+ */
+int main (int argc, char **argv) {
+	int count = 5000;
+	if (argc > 1) { count = atoi(argv[1]); }
+	setLogLevel(LOG_QUIET);
+	setParallelFormation(false); // draws per second on one core
+
+	const unsigned long long rawDraws = 100000000ULL;
+	cout << "raw draws (M/s): minstd_rand0 " << rawDrawsPerSecond<minstd_rand0>(rawDraws) / 1e6;
+	cout << ", xoshiro256** " << rawDrawsPerSecond<Xoshiro256StarStar>(rawDraws) / 1e6;
+	cout << ", pcg64 " << rawDrawsPerSecond<Pcg64>(rawDraws) / 1e6;
+	cout << ", philox4x32-10 " << rawDrawsPerSecond<Philox4x32>(rawDraws) / 1e6 << "\n";
+
+	GenerationOptions options;
+	vector<unsigned long long> systemDraws(count);
+	randomDrawCount = 0;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	size_t planets = 0;
+	for (int seed = 1; seed <= count; seed++) {
+		unsigned long long before = randomDrawCount;
+		StarSystem system = GenerateSystem(seed, options);
+		for (size_t d = 0; d < system.planetSystems.size(); d++) { planets += system.planetSystems[d].planets.size(); }
+		systemDraws[seed - 1] = randomDrawCount - before;
+	}
+	double seconds = secondsSince(start);
+
+	cout << RANDOM_ENGINE_NAME << " full generation: " << count << " systems (" << planets << " planets) in " << seconds << " s; ";
+	cout << (double) randomDrawCount / count << " draws/system, ";
+	cout << randomDrawCount / seconds / 1e6 << " M draws/s, ";
+	cout << count / seconds << " systems/s\n";
+
+	vector<unsigned long long> starDraws(count);
+	for (int seed = 1; seed <= count; seed++) {
+		unsigned long long before = randomDrawCount;
+		GenerateStars(seed, options);
+		starDraws[seed - 1] = randomDrawCount - before;
+	}
+	printDrawsPerSeed("stars", starDraws, 1);
+	printDrawsPerSeed("full system", systemDraws, 1);
+
+	return 0;
+}
+
+/* printDrawsPerSeed
+ * Median, 99th percentile and maximum of the draws per seed, and the seed
+ * that made the most; DRAWS[i] is for seed FIRSTSEED + i
+ */
+void printDrawsPerSeed (const char * stage, vector<unsigned long long> & draws, int firstSeed) {
+	size_t worst = max_element(draws.begin(), draws.end()) - draws.begin();
+	unsigned long long most = draws[worst];
+	vector<unsigned long long> sorted = draws;
+	sort(sorted.begin(), sorted.end());
+	cout << RANDOM_ENGINE_NAME << " draws per seed, " << stage << ": median " << sorted[sorted.size() / 2];
+	cout << ", p99 " << sorted[sorted.size() * 99 / 100] << ", max " << most << " (seed " << firstSeed + worst << ")\n";
+}
+
+template <class Engine>
+double rawDrawsPerSecond (unsigned long long draws) {
+	Engine engine(42);
+	unsigned long long sum = 0;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (unsigned long long i = 0; i < draws; i++) {
+		sum += engine();
+	}
+	double seconds = secondsSince(start);
+	// keep the loop from being optimised away
+	if (sum == 42) { cout << ""; }
+	return draws / seconds;
+}
+
+double secondsSince (chrono::steady_clock::time_point start) {
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
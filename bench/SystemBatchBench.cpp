@@ -0,0 +1,124 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include "../Generator.h"
+#include "../StarBatch.h"
+#include "../SystemBatch.h"
+#include "../Log.h"
+using namespace std;
+
+// Function declarations
+double worstRelativeError (const vector<double> & a, const vector<double> & b, const vector<unsigned char> & use);
+double secondsSince (chrono::steady_clock::time_point start);
+
+/* MAIN
+ * System batch benchmark; built by "make bench"
+ * Generates COUNT systems (default 20000), gathers their planets into a
+ * SystemBatch, and times the batch passes against the same formulas run
+ * planet by planet over the systems, as the pipeline stages run them, REPEAT
+ * times each (default 50).  Checks the batch results against the planets
+ * the generator made; exits with 1 if any differs by more than
+ * BATCH_TOLERANCE or a planet's tidal locking differs.
+ * Usage: SystemBatchBench [COUNT [REPEAT]]
+ */
+int main (int argc, char **argv) {
+	int count = 20000;
+	int repeat = 50;
+	if (argc > 1) { count = atoi(argv[1]); }
+	if (argc > 2) { repeat = atoi(argv[2]); }
+	setLogLevel(LOG_QUIET);
+
+	GenerationOptions options;
+	vector<StarSystem> systems;
+	SystemBatch batch;
+	for (int seed = 1; seed <= count; seed++) {
+		systems.push_back(GenerateSystem(seed, options));
+		batch.Add(systems.back());
+	}
+	size_t n = batch.Size();
+
+	// planet by planet, through the Planet accessors and pow
+	vector<double> radius(n), gravity(n), period(n), blackBody(n);
+	vector<unsigned char> locked(n);
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (int r = 0; r < repeat; r++) {
+		size_t j = 0;
+		for (size_t s = 0; s < systems.size(); s++) {
+			for (size_t d = 0; d < systems[s].planetSystems.size(); d++) {
+				const PlanetarySystem & disk = systems[s].planetSystems[d];
+				const Star & host = disk.hostStar;
+				for (size_t i = 0; i < disk.planets.size(); i++, j++) {
+					const Planet & p = disk.planets[i];
+					radius[j] = (disk.formedClasses[i] == PLANETOID_BELT) ? 0.0 : pow(p.GetMass() / p.GetDensity(), 1.0 / 3.0);
+					gravity[j] = p.GetDensity() * radius[j];
+					period[j] = sqrt(pow(p.GetDistance(), 3.0) / host.GetMass());
+					double tideLockRadius = pow(host.GetAge() * pow(host.GetMass(), 2.0) / 479.0, 1.0 / 6.0);
+					locked[j] = p.GetDistance() < tideLockRadius;
+					blackBody[j] = 278.0 * pow(host.GetLuminosity(), 0.25) / sqrt(p.GetDistance());
+				}
+			}
+		}
+	}
+	double scalarSeconds = secondsSince(start);
+
+	start = chrono::steady_clock::now();
+	for (int r = 0; r < repeat; r++) { runBatchPasses(batch); }
+	double batchSeconds = secondsSince(start);
+
+	// what the generator left in the planets
+	vector<double> eccentricity, lockedRotation;
+	for (size_t s = 0; s < systems.size(); s++) {
+		for (size_t d = 0; d < systems[s].planetSystems.size(); d++) {
+			for (const Planet & p : systems[s].planetSystems[d].planets) {
+				eccentricity.push_back(p.GetEccentricity());
+				lockedRotation.push_back(p.GetRotationPeriod());
+			}
+		}
+	}
+
+	vector<unsigned char> all(n, 1);
+	double eccentricityError = worstRelativeError(batch.eccentricity, eccentricity, all);
+	double radiusError = worstRelativeError(batch.radius, radius, all);
+	double gravityError = worstRelativeError(batch.gravity, gravity, all);
+	double periodError = worstRelativeError(batch.orbitalPeriod, period, all);
+	double rotationError = worstRelativeError(batch.lockedRotationPeriod, lockedRotation, locked);
+	double blackBodyError = worstRelativeError(batch.blackBodyTemperature, blackBody, all);
+	size_t lockDifferences = 0;
+	for (size_t i = 0; i < n; i++) {
+		if (batch.tidallyLocked[i] != locked[i]) { lockDifferences++; }
+	}
+
+	double planetPasses = (double) n * repeat;
+	cout << n << " planets from " << count << " systems: planet by planet " << planetPasses / scalarSeconds / 1e6;
+	cout << " M planets/s, batch " << planetPasses / batchSeconds / 1e6 << " M planets/s\n";
+	cout << "worst relative error vs the generator: eccentricity " << eccentricityError << ", radius " << radiusError;
+	cout << ", gravity " << gravityError << ", orbital period " << periodError << ", locked rotation " << rotationError;
+	cout << ", black-body temperature " << blackBodyError << "; " << lockDifferences << " tidal locks differ\n";
+
+	if (lockDifferences > 0 || eccentricityError > BATCH_TOLERANCE || radiusError > BATCH_TOLERANCE || gravityError > BATCH_TOLERANCE
+	    || periodError > BATCH_TOLERANCE || rotationError > BATCH_TOLERANCE || blackBodyError > BATCH_TOLERANCE) {
+		cerr << "System batch passes exceed the tolerance of " << BATCH_TOLERANCE << ".\n";
+		return 1;
+	}
+	return 0;
+}
+
+/* worstRelativeError
+ * Over the planets whose USE flag is set; equal values, zeros included,
+ * count as no error
+ */
+double worstRelativeError (const vector<double> & a, const vector<double> & b, const vector<unsigned char> & use) {
+	double worst = 0;
+	for (size_t i = 0; i < a.size(); i++) {
+		if (!use[i] || a[i] == b[i]) { continue; }
+		double error = fabs(a[i] - b[i]) / fabs(b[i]);
+		if (!(error <= worst)) { worst = error; }
+	}
+	return worst;
+}
+
+double secondsSince (chrono::steady_clock::time_point start) {
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
@@ -1,86 +1,42 @@
 #include <string>
 #include <iostream>
+#include <algorithm>        // partition_point
+#include "Star.h"
 #include "Planet.h"
+#include "AliasTable.h"
 using namespace std;
 
-string GetSpectralClass (double temp) {
-	if (temp <= 600) { return "Y0"; }
-	else if (temp <= 725) { return "T9"; }
-	else if (temp <= 775) { return "T8"; }
-	else if (temp <= 825) { return "T7"; }
-	else if (temp <= 875) { return "T6"; }
-	else if (temp <= 925) { return "T5"; }
-	else if (temp <= 975) { return "T4"; }
-	else if (temp <= 1050) { return "T3"; }
-	else if (temp <= 1150) { return "T2"; }
-	else if (temp <= 1250) { return "T1"; }
-	else if (temp <= 1350) { return "T0"; }
+/* GetSpectralClass
+ * Spectral type by effective temperature: Y0 at 600 K or less, then T9 to
+ * A1 each up to the temperature below, and A0 above 9550 K
+ */
+const double SPECTRAL_TEMPERATURES[70] = {
+	600,
+	725, 775, 825, 875, 925, 975, 1050, 1150, 1250, 1350,       // T9 - T0
+	1450, 1550, 1650, 1750, 1850, 1950, 2050, 2150, 2250, 2350, // L9 - L0
+	2450, 2575, 2725, 2900, 3100, 3300, 3475, 3625, 3775, 3910, // M9 - M0
+	4030, 4150, 4270, 4390, 4535, 4705, 4875, 5045, 5215, 5330, // K9 - K0
+	5390, 5450, 5510, 5570, 5630, 5690, 5750, 5810, 5870, 5960, // G9 - G0
+	6080, 6200, 6320, 6440, 6570, 6710, 6850, 6990, 7130, 7300, // F9 - F0
+	7500, 7700, 7900, 8100, 8350, 8650, 8950, 9250, 9550        // A9 - A1
+};
 
-	else if (temp <= 1450) { return "L9"; }
-	else if (temp <= 1550) { return "L8"; }
-	else if (temp <= 1650) { return "L7"; }
-	else if (temp <= 1750) { return "L6"; }
-	else if (temp <= 1850) { return "L5"; }
-	else if (temp <= 1950) { return "L4"; }
-	else if (temp <= 2050) { return "L3"; }
-	else if (temp <= 2150) { return "L2"; }
-	else if (temp <= 2250) { return "L1"; }
-	else if (temp <= 2350) { return "L0"; }
+SpectralType GetSpectralClass (double temp) {
+	// the first row whose temperature is at least TEMP, by binary search;
+	// NaN fails every test and so lands on A0
+	int row = partition_point(begin(SPECTRAL_TEMPERATURES), end(SPECTRAL_TEMPERATURES),
+		[temp](double t) { return !(temp <= t); }) - begin(SPECTRAL_TEMPERATURES);
 
-	else if (temp <= 2450) { return "M9"; }
-	else if (temp <= 2575) { return "M8"; }
-	else if (temp <= 2725) { return "M7"; }
-	else if (temp <= 2900) { return "M6"; }
-	else if (temp <= 3100) { return "M5"; }
-	else if (temp <= 3300) { return "M4"; }
-	else if (temp <= 3475) { return "M3"; }
-	else if (temp <= 3625) { return "M2"; }
-	else if (temp <= 3775) { return "M1"; }
-	else if (temp <= 3910) { return "M0"; }
-
-	else if (temp <= 4030) { return "K9"; }
-	else if (temp <= 4150) { return "K8"; }
-	else if (temp <= 4270) { return "K7"; }
-	else if (temp <= 4390) { return "K6"; }
-	else if (temp <= 4535) { return "K5"; }
-	else if (temp <= 4705) { return "K4"; }
-	else if (temp <= 4875) { return "K3"; }
-	else if (temp <= 5045) { return "K2"; }
-	else if (temp <= 5215) { return "K1"; }
-	else if (temp <= 5330) { return "K0"; }
-
-	else if (temp <= 5390) { return "G9"; }
-	else if (temp <= 5450) { return "G8"; }
-	else if (temp <= 5510) { return "G7"; }
-	else if (temp <= 5570) { return "G6"; }
-	else if (temp <= 5630) { return "G5"; }
-	else if (temp <= 5690) { return "G4"; }
-	else if (temp <= 5750) { return "G3"; }
-	else if (temp <= 5810) { return "G2"; }
-	else if (temp <= 5870) { return "G1"; }
-	else if (temp <= 5960) { return "G0"; }
-
-	else if (temp <= 6080) { return "F9"; }
-	else if (temp <= 6200) { return "F8"; }
-	else if (temp <= 6320) { return "F7"; }
-	else if (temp <= 6440) { return "F6"; }
-	else if (temp <= 6570) { return "F5"; }
-	else if (temp <= 6710) { return "F4"; }
-	else if (temp <= 6850) { return "F3"; }
-	else if (temp <= 6990) { return "F2"; }
-	else if (temp <= 7130) { return "F1"; }
-	else if (temp <= 7300) { return "F0"; }
-
-	else if (temp <= 7500) { return "A9"; }
-	else if (temp <= 7700) { return "A8"; }
-	else if (temp <= 7900) { return "A7"; }
-	else if (temp <= 8100) { return "A6"; }
-	else if (temp <= 8350) { return "A5"; }
-	else if (temp <= 8650) { return "A4"; }
-	else if (temp <= 8950) { return "A3"; }
-	else if (temp <= 9250) { return "A2"; }
-	else if (temp <= 9550) { return "A1"; }
-	else { return "A0"; }
+	SpectralType st;
+	if (row == 0) {
+		st.letter = SPECTRAL_Y;
+		st.subclass = 0;
+	}
+	else { // ten subclasses a letter, counting down from 9
+		st.letter = (SpectralLetter) (SPECTRAL_Y + (row + 9) / 10);
+		st.subclass = (10 - row % 10) % 10;
+	}
+	return st;
 }
 
 int getAccretionModifier (double pMass) {
@@ -122,18 +78,11 @@ double getTypicalEccentricity (int planets) {
 	else { return 0.05; }
 }
 
-double getFromMajorSatelliteOrbitalRatioTable (int roll) {
-	if (roll == 3) { return 1.406; }
-	else if (roll == 4) { return 1.432; }
-	else if (roll == 5) { return 1.452; }
-	else if (roll == 6) { return 1.480; }
-	else if (roll == 7) { return 1.500; }
-	else if (roll == 8) { return 1.550; }
-	else if (roll <= 12) { return 1.587; }
-	else if (roll == 13) { return 1.600; }
-	else if (roll == 14) { return 1.650; }
-	else if (roll == 15) { return 1.700; }
-	else if (roll == 16) { return 1.750; }
-	else if (roll == 17) { return 1.800; }
-	else /* roll == 18 */ { return 1.850; }
-}
+/* MOON_SPACING_TABLE
+ * Major satellite orbital ratio table: the ratio of each moon's orbit to the
+ * one inside it, by 3d6.  Rolls of 9 to 12 put the moon in a 2:1 resonance
+ * (ratio 1.587), and a second resonance then follows.
+ */
+constexpr AliasTable<13> MOON_SPACING_TABLE = makeThreeD6Table<13>({ 3, 4, 5, 6, 7, 8, 12, 13, 14, 15, 16, 17, 18 });
+const int MOON_SPACING_RESONANCE = 6;
+const double MOON_SPACING_RATIOS[13] = { 1.406, 1.432, 1.452, 1.480, 1.500, 1.550, 1.587, 1.600, 1.650, 1.700, 1.750, 1.800, 1.850 };